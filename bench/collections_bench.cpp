@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "collections/avl.hpp"
+#include "collections/btree_map.hpp"
+#include "collections/hash_map.hpp"
+#include "collections/string.h"
+#include "collections/string_view.h"
+#include "collections/vector.hpp"
+#include "harness.h"
+
+/// The number of elements processed by each invocation of a workload.
+static constexpr size_t ELEMENTS = 10000;
+/// The number of words in each line of the string benchmarks.
+static constexpr size_t WORDS_PER_LINE = 16;
+static constexpr unsigned SEED = 42;
+
+/// Keeps the results of the workloads observable, so the compiler cannot
+/// remove the measured code.
+static volatile size_t sink = 0;
+
+/// The inputs shared by the `vortex` and `std` variant of each benchmark, so
+/// both process exactly the same data.
+struct Dataset {
+        std::vector<std::string> keys;
+        std::vector<std::string> missingKeys;
+        std::vector<int> sortedInts;
+        std::vector<int> shuffledInts;
+        std::vector<std::string> paddedWords;
+        std::string line;
+
+        Vector<String> vortexKeys;
+        Vector<String> vortexMissingKeys;
+        Vector<String> vortexPaddedWords;
+        String vortexLine;
+
+        Dataset();
+};
+
+Dataset::Dataset() {
+        std::mt19937 random(SEED);
+        for (size_t i = 0; i < ELEMENTS; ++i) {
+                keys.push_back("key_" + std::to_string(i));
+                missingKeys.push_back("absent_" + std::to_string(i));
+                sortedInts.push_back((int)i);
+                paddedWords.push_back("  word_" + std::to_string(i) + " \t");
+        }
+        shuffledInts = sortedInts;
+        std::shuffle(shuffledInts.begin(), shuffledInts.end(), random);
+
+        for (size_t i = 0; i < WORDS_PER_LINE; ++i) {
+                line += "word_" + std::to_string(i) + "  ";
+        }
+
+        for (size_t i = 0; i < ELEMENTS; ++i) {
+                vortexKeys.pushBack(String(keys[i].c_str()));
+                vortexMissingKeys.pushBack(String(missingKeys[i].c_str()));
+                vortexPaddedWords.pushBack(String(paddedWords[i].c_str()));
+        }
+        vortexLine = line.c_str();
+}
+
+/// Registers the same benchmark for both implementations, so their results end
+/// up next to each other in the report.
+static void compare(BenchmarkSuite &suite, const char *name, size_t operations,
+                    const std::function<void()> &vortexWorkload,
+                    const std::function<void()> &stdWorkload) {
+        suite.run(String(name) + "/vortex", operations, vortexWorkload);
+        suite.run(String(name) + "/std", operations, stdWorkload);
+}
+
+static void vectorBenchmarks(BenchmarkSuite &suite, const Dataset &data) {
+        compare(
+            suite, "vector/push", ELEMENTS,
+            []() {
+                    Vector<size_t> values;
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            values.pushBack(i);
+                    }
+                    sink = values.length();
+            },
+            []() {
+                    std::vector<size_t> values;
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            values.push_back(i);
+                    }
+                    sink = values.size();
+            });
+
+        compare(
+            suite, "vector/push_reserved", ELEMENTS,
+            []() {
+                    Vector<size_t> values(ELEMENTS);
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            values.pushBack(i);
+                    }
+                    sink = values.length();
+            },
+            []() {
+                    std::vector<size_t> values;
+                    values.reserve(ELEMENTS);
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            values.push_back(i);
+                    }
+                    sink = values.size();
+            });
+
+        compare(
+            suite, "vector/push_pop", ELEMENTS,
+            []() {
+                    Vector<size_t> values;
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            values.pushBack(i);
+                    }
+                    size_t sum = 0;
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            sum += values.popBack().unwrap();
+                    }
+                    sink = sum;
+            },
+            []() {
+                    std::vector<size_t> values;
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            values.push_back(i);
+                    }
+                    size_t sum = 0;
+                    for (size_t i = 0; i < ELEMENTS; ++i) {
+                            sum += values.back();
+                            values.pop_back();
+                    }
+                    sink = sum;
+            });
+
+        compare(
+            suite, "vector/push_string", ELEMENTS,
+            [&data]() {
+                    Vector<String> values;
+                    for (const String &key : data.vortexKeys) {
+                            values.pushBack(key);
+                    }
+                    sink = values.length();
+            },
+            [&data]() {
+                    std::vector<std::string> values;
+                    for (const std::string &key : data.keys) {
+                            values.push_back(key);
+                    }
+                    sink = values.size();
+            });
+}
+
+static void hashMapBenchmarks(BenchmarkSuite &suite, const Dataset &data) {
+        compare(
+            suite, "hash_map/insert", ELEMENTS,
+            [&data]() {
+                    HashMap<String, size_t> map;
+                    size_t idx = 0;
+                    for (const String &key : data.vortexKeys) {
+                            map.insert(key, idx++);
+                    }
+                    sink = map.size();
+            },
+            [&data]() {
+                    std::unordered_map<std::string, size_t> map;
+                    size_t idx = 0;
+                    for (const std::string &key : data.keys) {
+                            map.emplace(key, idx++);
+                    }
+                    sink = map.size();
+            });
+
+        compare(
+            suite, "hash_map/insert_int", ELEMENTS,
+            [&data]() {
+                    HashMap<int, int> map;
+                    for (const int value : data.shuffledInts) {
+                            map.insert(value, value);
+                    }
+                    sink = map.size();
+            },
+            [&data]() {
+                    std::unordered_map<int, int> map;
+                    for (const int value : data.shuffledInts) {
+                            map.emplace(value, value);
+                    }
+                    sink = map.size();
+            });
+
+        // The lookups are measured on maps built once, outside the workload.
+        HashMap<String, size_t> vortexMap;
+        std::unordered_map<std::string, size_t> stdMap;
+        for (size_t i = 0; i < ELEMENTS; ++i) {
+                vortexMap.insert(data.vortexKeys[i].unwrap(), i);
+                stdMap.emplace(data.keys[i], i);
+        }
+
+        compare(
+            suite, "hash_map/lookup_hit", ELEMENTS,
+            [&data, &vortexMap]() {
+                    size_t sum = 0;
+                    for (const String &key : data.vortexKeys) {
+                            sum += vortexMap.getRef(key).unwrap();
+                    }
+                    sink = sum;
+            },
+            [&data, &stdMap]() {
+                    size_t sum = 0;
+                    for (const std::string &key : data.keys) {
+                            sum += stdMap.find(key)->second;
+                    }
+                    sink = sum;
+            });
+
+        compare(
+            suite, "hash_map/lookup_miss", ELEMENTS,
+            [&data, &vortexMap]() {
+                    size_t found = 0;
+                    for (const String &key : data.vortexMissingKeys) {
+                            found += vortexMap.contains(key);
+                    }
+                    sink = found;
+            },
+            [&data, &stdMap]() {
+                    size_t found = 0;
+                    for (const std::string &key : data.missingKeys) {
+                            found += stdMap.contains(key);
+                    }
+                    sink = found;
+            });
+}
+
+/// `AvlTree` only holds values, so it is compared with `std::set`, while
+/// `BTreeMap` is compared with `std::map`.
+static void treeBenchmarks(BenchmarkSuite &suite, const Dataset &data) {
+        for (const bool sorted : {true, false}) {
+                const std::vector<int> &values = sorted ? data.sortedInts : data.shuffledInts;
+                const String prefix = sorted ? "tree/insert_sorted" : "tree/insert_random";
+
+                suite.run(prefix + "/avl", ELEMENTS, [&values]() {
+                        AvlTree<int> tree;
+                        for (const int value : values) {
+                                tree.insert(value);
+                        }
+                        sink = tree.size();
+                });
+                suite.run(prefix + "/std_set", ELEMENTS, [&values]() {
+                        std::set<int> tree;
+                        for (const int value : values) {
+                                tree.insert(value);
+                        }
+                        sink = tree.size();
+                });
+                suite.run(prefix + "/btree", ELEMENTS, [&values]() {
+                        BTreeMap<int, int> tree;
+                        for (const int value : values) {
+                                tree.insert(value, value);
+                        }
+                        sink = tree.size();
+                });
+                suite.run(prefix + "/std_map", ELEMENTS, [&values]() {
+                        std::map<int, int> tree;
+                        for (const int value : values) {
+                                tree.emplace(value, value);
+                        }
+                        sink = tree.size();
+                });
+        }
+
+        AvlTree<int> avl;
+        std::set<int> stdSet;
+        BTreeMap<int, int> btree;
+        std::map<int, int> stdMap;
+        for (const int value : data.shuffledInts) {
+                avl.insert(value);
+                stdSet.insert(value);
+                btree.insert(value, value);
+                stdMap.emplace(value, value);
+        }
+
+        suite.run("tree/lookup/avl", ELEMENTS, [&data, &avl]() {
+                size_t found = 0;
+                for (const int value : data.shuffledInts) {
+                        found += avl.find(value).isSome();
+                }
+                sink = found;
+        });
+        suite.run("tree/lookup/std_set", ELEMENTS, [&data, &stdSet]() {
+                size_t found = 0;
+                for (const int value : data.shuffledInts) {
+                        found += stdSet.contains(value);
+                }
+                sink = found;
+        });
+        suite.run("tree/lookup/btree", ELEMENTS, [&data, &btree]() {
+                size_t found = 0;
+                for (const int value : data.shuffledInts) {
+                        found += btree.contains(value);
+                }
+                sink = found;
+        });
+        suite.run("tree/lookup/std_map", ELEMENTS, [&data, &stdMap]() {
+                size_t found = 0;
+                for (const int value : data.shuffledInts) {
+                        found += stdMap.contains(value);
+                }
+                sink = found;
+        });
+}
+
+static void stringBenchmarks(BenchmarkSuite &suite, const Dataset &data) {
+        static constexpr size_t LINES = ELEMENTS / WORDS_PER_LINE;
+
+        compare(
+            suite, "string/split", LINES * WORDS_PER_LINE,
+            [&data]() {
+                    size_t words = 0;
+                    for (size_t i = 0; i < LINES; ++i) {
+                            words += data.vortexLine.split(' ').length();
+                    }
+                    sink = words;
+            },
+            [&data]() {
+                    size_t words = 0;
+                    for (size_t i = 0; i < LINES; ++i) {
+                            std::vector<std::string> parts;
+                            size_t start = 0;
+                            while (start < data.line.size()) {
+                                    size_t end = data.line.find(' ', start);
+                                    if (end == std::string::npos) {
+                                            end = data.line.size();
+                                    }
+                                    if (end != start) {
+                                            parts.push_back(data.line.substr(start, end - start));
+                                    }
+                                    start = end + 1;
+                            }
+                            words += parts.size();
+                    }
+                    sink = words;
+            });
+
+        compare(
+            suite, "string/trim", ELEMENTS,
+            [&data]() {
+                    size_t length = 0;
+                    for (const String &word : data.vortexPaddedWords) {
+                            length += word.trim().length();
+                    }
+                    sink = length;
+            },
+            [&data]() {
+                    static const char *WHITESPACE = " \t\n\r";
+                    size_t length = 0;
+                    for (const std::string &word : data.paddedWords) {
+                            const size_t first = word.find_first_not_of(WHITESPACE);
+                            const size_t last = word.find_last_not_of(WHITESPACE);
+                            const std::string trimmed =
+                                first == std::string::npos ? "" : word.substr(first, last - first + 1);
+                            length += trimmed.size();
+                    }
+                    sink = length;
+            });
+
+        compare(
+            suite, "string/append", ELEMENTS,
+            [&data]() {
+                    String result;
+                    for (const String &key : data.vortexKeys) {
+                            result.append(key.cStr());
+                    }
+                    sink = result.length();
+            },
+            [&data]() {
+                    std::string result;
+                    for (const std::string &key : data.keys) {
+                            result.append(key);
+                    }
+                    sink = result.size();
+            });
+
+        compare(
+            suite, "string/concat", ELEMENTS,
+            [&data]() {
+                    size_t length = 0;
+                    for (const String &key : data.vortexKeys) {
+                            length += (key + key).length();
+                    }
+                    sink = length;
+            },
+            [&data]() {
+                    size_t length = 0;
+                    for (const std::string &key : data.keys) {
+                            length += (key + key).size();
+                    }
+                    sink = length;
+            });
+
+        // `String` caches its hash, so the characters are hashed through a
+        // view to measure the hash function itself.
+        compare(
+            suite, "string/hash", ELEMENTS,
+            [&data]() {
+                    size_t hash = 0;
+                    for (const String &key : data.vortexKeys) {
+                            hash ^= StringView(key).hash();
+                    }
+                    sink = hash;
+            },
+            [&data]() {
+                    size_t hash = 0;
+                    for (const std::string &key : data.keys) {
+                            hash ^= std::hash<std::string_view>()(key);
+                    }
+                    sink = hash;
+            });
+}
+
+int main(int argc, char *argv[]) {
+        try {
+                BenchmarkSuite suite("collections", argc, argv);
+                const Dataset data;
+
+                vectorBenchmarks(suite, data);
+                hashMapBenchmarks(suite, data);
+                treeBenchmarks(suite, data);
+                stringBenchmarks(suite, data);
+
+                suite.report(std::cout);
+
+        } catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+        }
+        return 0;
+}
@@ -0,0 +1,274 @@
+#include "harness.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <numeric>
+#include <stdexcept>
+
+static std::atomic<size_t> allocations = 0;
+
+void *operator new(size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        void *ptr = std::malloc(size == 0 ? 1 : size);
+        if (nullptr == ptr) {
+                throw std::bad_alloc();
+        }
+        return ptr;
+}
+
+void *operator new(size_t size, std::align_val_t alignment) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        // `aligned_alloc` requires the size to be a multiple of the alignment.
+        const size_t align = static_cast<size_t>(alignment);
+        const size_t rounded = (std::max(size, (size_t)1) + align - 1) / align * align;
+        void *ptr = std::aligned_alloc(align, rounded);
+        if (nullptr == ptr) {
+                throw std::bad_alloc();
+        }
+        return ptr;
+}
+
+// The array and `nothrow` forms of the standard library forward to the ones
+// above, so only the plain forms need replacing.
+void operator delete(void *ptr) noexcept {
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept {
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+        std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t, std::align_val_t) noexcept {
+        std::free(ptr);
+}
+
+BenchmarkResult::BenchmarkResult(const String &_name, size_t _operations,
+                                 std::vector<double> &&_durationsNs, size_t _allocations)
+    : name(_name),
+      operations(_operations),
+      durationsNs(std::move(_durationsNs)),
+      allocations(_allocations) {
+}
+
+const String &BenchmarkResult::getName() const {
+        return name;
+}
+
+size_t BenchmarkResult::getOperations() const {
+        return operations;
+}
+
+size_t BenchmarkResult::getRepetitions() const {
+        return durationsNs.size();
+}
+
+double BenchmarkResult::meanNs() const {
+        if (durationsNs.empty()) {
+                return 0;
+        }
+        return std::accumulate(durationsNs.begin(), durationsNs.end(), 0.0) /
+               (double)durationsNs.size();
+}
+
+double BenchmarkResult::varianceNs() const {
+        if (durationsNs.size() < 2) {
+                return 0;
+        }
+        const double mean = meanNs();
+        double sum = 0;
+        for (const double duration : durationsNs) {
+                sum += (duration - mean) * (duration - mean);
+        }
+        return sum / (double)(durationsNs.size() - 1);
+}
+
+double BenchmarkResult::stddevNs() const {
+        return std::sqrt(varianceNs());
+}
+
+double BenchmarkResult::minNs() const {
+        if (durationsNs.empty()) {
+                return 0;
+        }
+        return *std::min_element(durationsNs.begin(), durationsNs.end());
+}
+
+double BenchmarkResult::maxNs() const {
+        if (durationsNs.empty()) {
+                return 0;
+        }
+        return *std::max_element(durationsNs.begin(), durationsNs.end());
+}
+
+double BenchmarkResult::medianNs() const {
+        if (durationsNs.empty()) {
+                return 0;
+        }
+        std::vector<double> sorted = durationsNs;
+        std::sort(sorted.begin(), sorted.end());
+        const size_t middle = sorted.size() / 2;
+        if (sorted.size() % 2 == 0) {
+                return (sorted[middle - 1] + sorted[middle]) / 2;
+        }
+        return sorted[middle];
+}
+
+double BenchmarkResult::nsPerOperation() const {
+        if (operations == 0) {
+                return 0;
+        }
+        return meanNs() / (double)operations;
+}
+
+double BenchmarkResult::operationsPerSecond() const {
+        const double ns = nsPerOperation();
+        if (ns == 0) {
+                return 0;
+        }
+        return 1e9 / ns;
+}
+
+double BenchmarkResult::allocationsPerOperation() const {
+        if (operations == 0 || durationsNs.empty()) {
+                return 0;
+        }
+        return (double)allocations / (double)(durationsNs.size() * operations);
+}
+
+static size_t parseCount(const char *option, const char *value) {
+        try {
+                return atou(value);
+        } catch (const std::invalid_argument &) {
+                const String msg = String("Expected a number for ") + option + ", but received: " + value;
+                throw std::invalid_argument(msg.cStr());
+        }
+}
+
+BenchmarkSuite::BenchmarkSuite(const String &_suiteName, int argc, char *argv[])
+    : suiteName(_suiteName) {
+        for (int i = 1; i < argc; ++i) {
+                const char *option = argv[i];
+                if (i + 1 >= argc) {
+                        const String msg = String("Missing value for option: ") + option;
+                        throw std::invalid_argument(msg.cStr());
+                }
+                const char *value = argv[++i];
+
+                if (0 == strcmp(option, "--warmup")) {
+                        warmup = parseCount(option, value);
+                } else if (0 == strcmp(option, "--repetitions")) {
+                        repetitions = std::max(parseCount(option, value), (size_t)1);
+                } else if (0 == strcmp(option, "--filter")) {
+                        filter = value;
+                } else if (0 == strcmp(option, "--json")) {
+                        jsonFilename = value;
+                } else {
+                        const String msg = String("Unknown option: ") + option;
+                        throw std::invalid_argument(msg.cStr());
+                }
+        }
+}
+
+bool BenchmarkSuite::isSelected(const String &name) const {
+        return filter.isEmpty() || strstr(name.cStr(), filter.cStr()) != nullptr;
+}
+
+void BenchmarkSuite::run(const String &name, size_t operations,
+                         const std::function<void()> &workload) {
+        if (!isSelected(name)) {
+                return;
+        }
+
+        for (size_t i = 0; i < warmup; ++i) {
+                workload();
+        }
+
+        std::vector<double> durationsNs;
+        // Reserving up front keeps the harness' own allocations out of the
+        // counted ones.
+        durationsNs.reserve(repetitions);
+        size_t measuredAllocations = 0;
+        for (size_t i = 0; i < repetitions; ++i) {
+                const size_t allocationsBefore = allocationCount();
+                const Clock::time_point start = Clock::now();
+                workload();
+                const Clock::time_point end = Clock::now();
+                measuredAllocations += allocationCount() - allocationsBefore;
+                durationsNs.push_back(
+                    (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+        results.emplace_back(name, operations, std::move(durationsNs), measuredAllocations);
+}
+
+size_t BenchmarkSuite::allocationCount() {
+        return allocations.load(std::memory_order_relaxed);
+}
+
+void BenchmarkSuite::writeTable(std::ostream &out) const {
+        out << std::left << std::setw(32) << "benchmark" << std::right << std::setw(12) << "ops"
+            << std::setw(14) << "mean us" << std::setw(10) << "stddev %" << std::setw(12)
+            << "ns/op" << std::setw(16) << "ops/s" << std::setw(12) << "allocs/op" << '\n';
+        for (const BenchmarkResult &result : results) {
+                const double mean = result.meanNs();
+                const double relativeStddev = mean == 0 ? 0 : 100.0 * result.stddevNs() / mean;
+                out << std::left << std::setw(32) << result.getName() << std::right
+                    << std::setw(12) << result.getOperations() << std::fixed
+                    << std::setprecision(1) << std::setw(14) << mean / 1e3 << std::setw(10)
+                    << relativeStddev << std::setprecision(3) << std::setw(12)
+                    << result.nsPerOperation() << std::setprecision(0) << std::setw(16)
+                    << result.operationsPerSecond() << std::setprecision(3) << std::setw(12)
+                    << result.allocationsPerOperation() << '\n';
+        }
+}
+
+void BenchmarkSuite::writeJson(std::ostream &out) const {
+        out << std::setprecision(3) << std::fixed;
+        out << "{\n";
+        out << "  \"suite\": \"" << suiteName << "\",\n";
+        out << "  \"warmup\": " << warmup << ",\n";
+        out << "  \"repetitions\": " << repetitions << ",\n";
+        out << "  \"benchmarks\": [";
+        for (size_t i = 0; i < results.size(); ++i) {
+                const BenchmarkResult &result = results[i];
+                out << (i == 0 ? "\n" : ",\n");
+                out << "    {\n";
+                out << "      \"name\": \"" << result.getName() << "\",\n";
+                out << "      \"operations\": " << result.getOperations() << ",\n";
+                out << "      \"repetitions\": " << result.getRepetitions() << ",\n";
+                out << "      \"mean_ns\": " << result.meanNs() << ",\n";
+                out << "      \"median_ns\": " << result.medianNs() << ",\n";
+                out << "      \"min_ns\": " << result.minNs() << ",\n";
+                out << "      \"max_ns\": " << result.maxNs() << ",\n";
+                out << "      \"variance_ns2\": " << result.varianceNs() << ",\n";
+                out << "      \"stddev_ns\": " << result.stddevNs() << ",\n";
+                out << "      \"ns_per_op\": " << result.nsPerOperation() << ",\n";
+                out << "      \"ops_per_sec\": " << result.operationsPerSecond() << ",\n";
+                out << "      \"allocs_per_op\": " << result.allocationsPerOperation() << "\n";
+                out << "    }";
+        }
+        out << "\n  ]\n}\n";
+}
+
+void BenchmarkSuite::report(std::ostream &out) const {
+        writeTable(out);
+        if (jsonFilename.isEmpty()) {
+                return;
+        }
+
+        std::ofstream json(jsonFilename.cStr());
+        if (!json.is_open()) {
+                const String msg = String("Could not open file: ") + jsonFilename;
+                throw std::runtime_error(msg.cStr());
+        }
+        writeJson(json);
+}
@@ -0,0 +1,100 @@
+#ifndef VORTEX_BENCH_HARNESS_H
+#define VORTEX_BENCH_HARNESS_H
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include "collections/string.h"
+#include "collections/vector.hpp"
+
+/// The timings of all repetitions of a single benchmark, along with the number
+/// of operations performed by each repetition, which are used for normalizing
+/// the results, and the number of heap allocations made by the repetitions.
+class BenchmarkResult {
+       private:
+        String name;
+        size_t operations;
+        std::vector<double> durationsNs;
+        size_t allocations = 0;
+
+       public:
+        BenchmarkResult() = default;
+        BenchmarkResult(const String &, size_t, std::vector<double> &&, size_t);
+
+        const String &getName() const;
+        size_t getOperations() const;
+        size_t getRepetitions() const;
+
+        double meanNs() const;
+        double varianceNs() const;
+        double stddevNs() const;
+        double minNs() const;
+        double maxNs() const;
+        double medianNs() const;
+
+        /// The mean duration of a single operation.
+        double nsPerOperation() const;
+        /// The mean throughput, derived from `nsPerOperation`.
+        double operationsPerSecond() const;
+        /// The mean number of heap allocations per operation.
+        double allocationsPerOperation() const;
+};
+
+/// A minimal benchmark runner, which executes each registered workload a
+/// number of times for warming up the caches and the branch predictors,
+/// followed by the measured repetitions.
+///
+/// The harness replaces the global `operator new`, so every benchmark also
+/// reports the heap allocations made by its workload - including the ones of
+/// the standard library containers.
+///
+/// The behaviour is controlled through the command line arguments:
+/// ```
+/// --warmup <n>       unmeasured runs before the repetitions
+/// --repetitions <n>  measured runs of each benchmark
+/// --filter <text>    only runs the benchmarks, whose name contains the text
+/// --json <file>      also writes the results in JSON format to the file
+/// ```
+class BenchmarkSuite {
+       public:
+        using Clock = std::chrono::steady_clock;
+
+       private:
+        static constexpr size_t DEFAULT_WARMUP = 3;
+        static constexpr size_t DEFAULT_REPETITIONS = 15;
+
+        String suiteName;
+        size_t warmup = DEFAULT_WARMUP;
+        size_t repetitions = DEFAULT_REPETITIONS;
+        String filter;
+        String jsonFilename;
+
+        std::vector<BenchmarkResult> results;
+
+        void writeTable(std::ostream &) const;
+        void writeJson(std::ostream &) const;
+
+       public:
+        /// Throws `std::invalid_argument` on unknown or malformed arguments.
+        BenchmarkSuite(const String &, int, char *[]);
+
+        /// Checks whether the benchmark with the given name is selected by the
+        /// `--filter` argument.
+        bool isSelected(const String &) const;
+
+        /// Measures the given workload, where each invocation performs the
+        /// given number of operations.
+        void run(const String &, size_t, const std::function<void()> &);
+
+        /// The number of heap allocations made by the process so far.
+        static size_t allocationCount();
+
+        /// Prints the results as a table to the output stream and writes them
+        /// to the JSON file, if one was requested.
+        void report(std::ostream &) const;
+};
+
+#endif
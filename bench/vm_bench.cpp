@@ -0,0 +1,180 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "harness.h"
+#include "parser.h"
+#include "profiler.h"
+#include "program.h"
+#include "vm.h"
+
+/// The number of loop iterations of each micro benchmark.
+static constexpr size_t MICRO_ITERATIONS = 20000;
+/// The number of copies of the measured instruction inside the loop body, which
+/// amortize the cost of the loop control instructions.
+static constexpr size_t MICRO_UNROLL = 16;
+/// The number of labels in the source of the parsing benchmarks.
+static constexpr size_t PARSE_LABELS = 2000;
+/// The number of instructions under each label of `parseProgram`.
+static constexpr size_t PARSE_LABEL_INSTRUCTIONS = 5;
+
+static const char *ENTRYPOINT_LABEL = "main";
+static const char *SQUARE_FUNCTION = "square:\nmov r5 r3\nmul r5 r3\nreturn";
+
+/// The native counterpart of `SQUARE_FUNCTION`, called via `ncall`.
+static double square(double value) {
+        return value * value;
+}
+
+/// Counts the instructions executed by a single run of the program with a
+/// profiled execution.
+static size_t countExecutions(const Program &program) {
+        const size_t entry = program.findLabel(ENTRYPOINT_LABEL).expect("No entry point found");
+        Profiler profiler(program.getInstructions(), program.getSourceMap(), entry);
+        Vm vm;
+        vm.setNextInstruction(entry);
+        vm.execute(program.getInstructions(), profiler);
+        return profiler.totalExecutions();
+}
+
+static void benchmark(BenchmarkSuite &suite, const String &name, std::istream &source,
+                      bool inlining = true) {
+        if (!suite.isSelected(name)) {
+                return;
+        }
+        Parser parser;
+        parser.setInlining(inlining);
+        const Program program = parser.compile(source, name);
+        const size_t executions = countExecutions(program);
+
+        // The program is compiled once and the same VM is reused by every
+        // run, so only the execution itself is measured.
+        Vm vm;
+        suite.run(name, executions, [&vm, &program]() { vm.run(program, ENTRYPOINT_LABEL); });
+}
+
+/// Builds a loop, whose body repeats the given snippet `MICRO_UNROLL` times.
+/// Every `#` inside the snippet is replaced by the index of the copy, allowing
+/// for unique labels. The registers `r1` and `r2` hold the values 1 and 2, and
+/// `r15` is reserved for the loop counter.
+static String microProgram(const char *snippet, const char *functions = "") {
+        std::ostringstream source;
+        source << functions << "\nmain:\n";
+        source << "mov r1 1\nmov r2 2\nmov r3 0\nmov r4 1\nmov r5 0\nmov r6 0\nmov r15 0\n";
+        source << "loop:\n";
+        for (size_t copy = 0; copy < MICRO_UNROLL; ++copy) {
+                for (const char *c = snippet; *c != '\0'; ++c) {
+                        if (*c == '#') {
+                                source << copy;
+                        } else {
+                                source << *c;
+                        }
+                }
+                source << '\n';
+        }
+        source << "add r15 1\niflt r15 " << MICRO_ITERATIONS << "\njmp loop\n";
+        return source.str().c_str();
+}
+
+static void microBenchmark(BenchmarkSuite &suite, const String &name, const char *snippet,
+                           const char *functions = "", bool inlining = true) {
+        std::istringstream source(microProgram(snippet, functions).cStr());
+        benchmark(suite, name, source, inlining);
+}
+
+/// Builds a source with many labels, each of which is referenced both before
+/// and after its declaration.
+static String parseProgram() {
+        std::ostringstream source;
+        source << "main:\n";
+        for (size_t i = 0; i < PARSE_LABELS; ++i) {
+                source << "label" << i << ":\n";
+                source << "mov r1 " << i << "\nadd r1 r2\niflt r1 r2\n";
+                source << "jmp label" << (i + 1) % PARSE_LABELS << "\n";
+                source << "call label" << i / 2 << "\n";
+        }
+        return source.str().c_str();
+}
+
+/// Measures the compilation of `parseProgram` with a parser, set up by the
+/// given function. The inlining is disabled, since the single pass mode does
+/// not perform it.
+static void parseBenchmark(BenchmarkSuite &suite, const String &name, void (*configure)(Parser &)) {
+        if (!suite.isSelected(name)) {
+                return;
+        }
+        const String source = parseProgram();
+        suite.run(name, PARSE_LABELS * PARSE_LABEL_INSTRUCTIONS, [&source, configure]() {
+                std::istringstream sourceCode(source.cStr());
+                Parser parser;
+                parser.setInlining(false);
+                configure(parser);
+                const Program program = parser.compile(sourceCode, "parse");
+        });
+}
+
+static void fileBenchmark(BenchmarkSuite &suite, const String &name, const char *filename) {
+        std::ifstream source(filename);
+        if (!source.is_open()) {
+                std::cerr << "Skipping " << name << ": could not open " << filename << std::endl;
+                return;
+        }
+        benchmark(suite, name, source);
+}
+
+int main(int argc, char *argv[]) {
+        // The scripts print their results, which would only clutter the
+        // benchmark output.
+        std::ostringstream discarded;
+        std::streambuf *const stdoutBuffer = std::cout.rdbuf(discarded.rdbuf());
+
+        try {
+                BenchmarkSuite suite("vm", argc, argv);
+                HostFunctions::getGlobal().define("square", square);
+
+                microBenchmark(suite, "dispatch/mov_literal", "mov r3 7");
+                microBenchmark(suite, "dispatch/mov_register", "mov r3 r2");
+                microBenchmark(suite, "dispatch/add", "add r3 r1");
+                microBenchmark(suite, "dispatch/mul", "mul r4 r1");
+                microBenchmark(suite, "dispatch/div", "div r4 r1");
+                microBenchmark(suite, "dispatch/mod", "mod r3 r2");
+                microBenchmark(suite, "dispatch/and", "and r3 r1");
+                microBenchmark(suite, "dispatch/addf", "addf r3 r1");
+                microBenchmark(suite, "dispatch/mulf", "mulf r4 r1");
+                microBenchmark(suite, "dispatch/divf", "divf r4 r1");
+                microBenchmark(suite, "dispatch/sqrt", "sqrt r3 r2");
+                microBenchmark(suite, "dispatch/sin", "sin r3 r2");
+                microBenchmark(suite, "dispatch/fma", "fma r3 r1 r2");
+                microBenchmark(suite, "dispatch/jmp", "jmp next#\nnext#:");
+                microBenchmark(suite, "dispatch/if_taken", "iflt r1 r2\nmov r3 r1");
+                microBenchmark(suite, "dispatch/if_not_taken", "ifgt r1 r2\nmov r3 r1");
+                microBenchmark(suite, "stack/push_pop", "push r1\npop r3");
+                microBenchmark(suite, "stack/push_pop_nested", "push r1\npush r2\npop r3\npop r3");
+                microBenchmark(suite, "call/call_return", "call noop", "noop:\nreturn", false);
+                microBenchmark(suite, "call/call_return_inlined", "call noop", "noop:\nreturn");
+                microBenchmark(suite, "call/call_body", "call square", SQUARE_FUNCTION, false);
+                microBenchmark(suite, "call/call_body_inlined", "call square", SQUARE_FUNCTION);
+                microBenchmark(suite, "call/ncall", "mov r0 r3\nncall square");
+                microBenchmark(suite, "branch/parity_loop",
+                               "mov r5 r15\nmod r5 2\nifeq r5 r3\nadd r6 1\nifneq r5 r3\nsub r6 1");
+
+                parseBenchmark(suite, "parse/two_pass", [](Parser &) {});
+                parseBenchmark(suite, "parse/single_pass",
+                               [](Parser &parser) { parser.setSinglePass(true); });
+                parseBenchmark(suite, "parse/lazy",
+                               [](Parser &parser) { parser.setLazyLinking(true); });
+
+                fileBenchmark(suite, "macro/fib", "examples/fib.vx");
+                fileBenchmark(suite, "macro/math", "examples/math.vx");
+                fileBenchmark(suite, "macro/intrinsics", "examples/intrinsics.vx");
+
+                std::cout.rdbuf(stdoutBuffer);
+                suite.report(std::cout);
+
+        } catch (const std::exception &e) {
+                std::cout.rdbuf(stdoutBuffer);
+                std::cerr << e.what() << std::endl;
+                return 1;
+        }
+        return 0;
+}
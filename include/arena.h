@@ -0,0 +1,122 @@
+#ifndef VORTEX_ARENA_H
+#define VORTEX_ARENA_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "collections/memory_resource.h"
+#include "collections/vector.hpp"
+
+/// A bump allocator, which hands out memory from large chunks and releases it
+/// all at once when the arena is destroyed or reset. Allocating is a pointer
+/// increment and the objects allocated one after another end up next to each
+/// other in memory.
+///
+/// The chunks are never moved, so the allocated objects stay in place even if
+/// the arena itself is moved.
+///
+/// An arena is also the monotonic `MemoryResource` for the collections -
+/// freeing memory back to it does nothing, so a collection built inside an
+/// arena only costs bump allocations and is released together with it.
+class Arena : public MemoryResource {
+       public:
+        /// Redirects the allocations of the `ArenaAllocated` types on the
+        /// current thread to the arena for the lifetime of the scope.
+        class Scope {
+               private:
+                Arena *previous;
+
+               public:
+                Scope(Arena &);
+                Scope(const Scope &) = delete;
+                ~Scope();
+
+                Scope &operator=(const Scope &) = delete;
+        };
+
+       private:
+        static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+        /// The objects built by `create`, which need to be destroyed together
+        /// with the arena.
+        struct Destructor {
+                void (*destroy)(void *);
+                void *object;
+        };
+
+        Vector<char *> chunks;
+        char *cursor = nullptr;
+        char *limit = nullptr;
+        size_t used = 0;
+        Vector<Destructor> destructors;
+
+        static thread_local Arena *current;
+
+        void free();
+        void move(Arena &&) noexcept;
+
+        void *allocateChunk(size_t, size_t);
+
+       public:
+        Arena() = default;
+        Arena(const Arena &) = delete;
+        Arena(Arena &&) noexcept;
+        ~Arena();
+
+        Arena &operator=(const Arena &) = delete;
+        Arena &operator=(Arena &&) noexcept;
+
+        /// Returns uninitialized memory of the given size and alignment, which
+        /// lives as long as the arena.
+        void *allocate(size_t, size_t = alignof(std::max_align_t)) override;
+        /// Does nothing - the memory is only released together with the arena.
+        void deallocate(void *, size_t, size_t) override;
+        /// Constructs an object inside the arena. Its destructor is run when
+        /// the arena is destroyed or reset.
+        template <typename T, typename... Args>
+        T *create(Args &&...);
+
+        /// Takes over the memory and the created objects of the other arena,
+        /// which is left empty. The objects stay in place, so the arenas
+        /// filled on separate threads can be merged into one owner.
+        void adopt(Arena &&);
+        /// Destroys the created objects and releases all memory at once.
+        void reset();
+        /// The number of bytes handed out by the arena.
+        size_t bytesUsed() const;
+
+        /// The arena of the innermost active `Scope` on the current thread, or
+        /// `nullptr` if there is none.
+        static Arena *getCurrent();
+};
+
+template <typename T, typename... Args>
+T *Arena::create(Args &&...args) {
+        T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+                destructors.pushBack(
+                    Destructor{[](void *ptr) { static_cast<T *>(ptr)->~T(); }, object});
+        }
+        return object;
+}
+
+/// A base for the polymorphic types, which are created in large numbers and
+/// owned through a `Box` - such as the instructions and their operands. While
+/// an `Arena::Scope` is active, `new` places them in its arena instead of
+/// allocating each one on the heap. Deleting such an object only runs its
+/// destructor and the memory is released together with the arena, which must
+/// therefore outlive the object.
+class ArenaAllocated {
+       private:
+        /// Each object is preceded by a header, which tells whether it is
+        /// placed in an arena.
+        static constexpr size_t HEADER_SIZE = alignof(std::max_align_t);
+
+       public:
+        static void *operator new(size_t);
+        static void operator delete(void *);
+};
+
+#endif
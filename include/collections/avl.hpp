@@ -2,10 +2,12 @@
 #define VORTEX_AVL_H
 
 #include <cmath>
+#include <cstdint>
 
 #include "option.hpp"
 #include "string.h"
 #include "traits.hpp"
+#include "vector.hpp"
 
 class AvlTreeException : public std::exception {
        protected:
@@ -26,43 +28,64 @@ class AvlTreeNode {
         enum class Balance;
 
        private:
+        static constexpr uint32_t NIL = UINT32_MAX;
+
         T value;
-        AvlTreeNode<T> *left = nullptr;
-        AvlTreeNode<T> *right = nullptr;
+        uint32_t left = NIL;
+        uint32_t right = NIL;
         unsigned depth = 1;
 
+       public:
+        AvlTreeNode(T &&);
+
        private:
-        AvlTreeNode(T);
-        AvlTreeNode(const AvlTreeNode &)
-                requires vortex::Cloneable<T>;
-        AvlTreeNode(AvlTreeNode &&) noexcept
-                requires vortex::Moveable<T>;
-        ~AvlTreeNode();
+        enum class Balance {
+                Balanced,
+                LeftLeft,
+                LeftRight,
+                RightLeft,
+                RightRight,
+        };
 
-        AvlTreeNode &operator=(const AvlTreeNode &)
-                requires vortex::Cloneable<T>;
-        AvlTreeNode &operator=(AvlTreeNode &&) noexcept
-                requires vortex::Moveable<T>;
+        friend class AvlTree<T>;
+};
 
-        static AvlTreeNode *insert(AvlTreeNode *, T);
+/// A self-balancing binary search tree.
+///
+/// The nodes are not allocated one by one, but live in a single pool - a
+/// `Vector` owned by the tree - and refer to their children by index. Building
+/// a tree costs a handful of allocations instead of one per node and the nodes
+/// inserted together stay next to each other in memory. Since the nodes are
+/// never removed, the pool needs no free list.
+///
+/// Both the insertion and the lookup walk the tree iteratively - the insertion
+/// records the path from the root, which it then retraces to rebalance it, up
+/// to the first subtree, whose depth does not change.
+template <vortex::Comparable T>
+class AvlTree {
+       private:
+        using Node = AvlTreeNode<T>;
+        using Balance = AvlTreeNode<T>::Balance;
 
-        template <typename Comparator>
-                requires vortex::Comparable<T, Comparator>
-        static Option<const T &> find(const AvlTreeNode *, const Comparator &);
+        static constexpr uint32_t NIL = Node::NIL;
+        /// An AVL tree is at most ~1.44 log2(n) deep, so any tree with 32-bit
+        /// node indices fits.
+        static constexpr size_t MAX_DEPTH = 64;
 
-       private:
-        void clone(const AvlTreeNode &)
-                requires vortex::Cloneable<T>;
-        void move(AvlTreeNode &&) noexcept
-                requires vortex::Moveable<T>;
-        void free();
-        static void safeUpdateDepth(AvlTreeNode *);
+        Vector<Node> nodes;
+        uint32_t root = NIL;
 
-        unsigned leftDepth() const;
-        unsigned rightDepth() const;
-        int depthDiff() const;
+        /// The node at the index. The indices only come from the tree itself,
+        /// so they are not checked.
+        Node &node(uint32_t);
+        const Node &node(uint32_t) const;
 
-        Balance getBalance() const;
+        unsigned depthOf(uint32_t) const;
+        void updateDepth(uint32_t);
+        int depthDiff(uint32_t) const;
+        Balance getBalance(uint32_t) const;
+        /// Restores the balance of the subtree and returns its new root.
+        uint32_t rebalance(uint32_t);
 
         /* Performs the following movement:
          *     R               K
@@ -71,7 +94,7 @@ class AvlTreeNode {
          *      / \         / \
          *     T2  T3      T1 T2
          */
-        AvlTreeNode *rotateLeft();
+        uint32_t rotateLeft(uint32_t);
 
         /* Performs the following movement:
          *      R          K
@@ -80,346 +103,243 @@ class AvlTreeNode {
          *   / \            / \
          *  T1  T2         T2  T3
          */
-        AvlTreeNode *rotateRight();
+        uint32_t rotateRight(uint32_t);
 
-       private:
-        enum class Balance {
-                Balanced,
-                LeftLeft,
-                LeftRight,
-                RightLeft,
-                RightRight,
-        };
-
-        friend class AvlTree<T>;
-};
-
-template <vortex::Comparable T>
-class AvlTree {
-       private:
-        AvlTreeNode<T> *root = nullptr;
-
-        void copy(const AvlTree &)
-                requires vortex::Cloneable<T>;
-        void move(AvlTree &&) noexcept
-                requires vortex::Moveable<T>;
-        void free();
+        /// Links the sorted nodes between the two indices into a perfectly
+        /// balanced subtree and returns its root.
+        uint32_t link(uint32_t, uint32_t);
 
        public:
         AvlTree() = default;
-        AvlTree(const AvlTree &)
-                requires vortex::Cloneable<T>;
-        AvlTree(AvlTree &&) noexcept
-                requires vortex::Moveable<T>;
-        ~AvlTree();
-
-        AvlTree &operator=(const AvlTree &)
-                requires vortex::Cloneable<T>;
-        AvlTree &operator=(AvlTree &&) noexcept
-                requires vortex::Moveable<T>;
-
+        /// Builds a tree, whose pool has room for the given number of nodes.
+        AvlTree(size_t);
+        /// Builds a tree, whose pool is allocated from the given resource.
+        AvlTree(MemoryResource &);
+
+        /// Builds a balanced tree out of strictly ascending values in O(n),
+        /// without any comparisons or rotations. Throws `AvlTreeException` if
+        /// the values are not strictly ascending.
+        static AvlTree buildFromSorted(Vector<T> &&);
+
+        /// Inserts the value, moving it into the tree. Throws
+        /// `AvlTreeException` if an equal value is already present.
         void insert(T value);
 
         template <typename Comparator>
                 requires vortex::Comparable<T, Comparator>
         Option<const T &> find(const Comparator &) const;
-};
 
-template <vortex::Comparable T>
-AvlTreeNode<T>::AvlTreeNode(T val) : value(val) {
-}
-
-template <vortex::Comparable T>
-AvlTreeNode<T>::AvlTreeNode(const AvlTreeNode &other)
-        requires vortex::Cloneable<T>
-{
-        clone(other);
-}
-
-template <vortex::Comparable T>
-AvlTreeNode<T>::AvlTreeNode(AvlTreeNode &&other) noexcept
-        requires vortex::Moveable<T>
-{
-        move(std::move(other));
-}
-
-template <vortex::Comparable T>
-AvlTreeNode<T>::~AvlTreeNode() {
-        free();
-}
-
-template <vortex::Comparable T>
-AvlTreeNode<T> &AvlTreeNode<T>::operator=(const AvlTreeNode &other)
-        requires vortex::Cloneable<T>
-{
-        if (this != &other) {
-                free();
-                clone(other);
-        }
-        return *this;
-}
-
-template <vortex::Comparable T>
-AvlTreeNode<T> &AvlTreeNode<T>::operator=(AvlTreeNode &&other) noexcept
-        requires vortex::Moveable<T>
-{
-        if (this != &other) {
-                free();
-                move(std::move(other));
-        }
-        return *this;
-}
-
-template <vortex::Comparable T>
-AvlTreeNode<T> *AvlTreeNode<T>::insert(AvlTreeNode *node, T value) {
-        if (node == nullptr) {
-                return new AvlTreeNode<T>(value);
-        }
-
-        if (value < node->value) {
-                node->left = insert(node->left, value);
-        } else if (value > node->value) {
-                node->right = insert(node->right, value);
-        } else {
-                throw AvlTreeException("Inserting a duplicate value inside AVL tree");
-        }
-
-        safeUpdateDepth(node);
-
-        const Balance balance = node->getBalance();
-        switch (balance) {
-                case Balance::Balanced:
-                        return node;
-                case Balance::LeftLeft:
-                        return node->rotateRight();
-                case Balance::LeftRight:
-                        node->left = node->left->rotateLeft();
-                        return node->rotateRight();
-                case Balance::RightLeft:
-                        node->right = node->right->rotateRight();
-                        return node->rotateLeft();
-                case Balance::RightRight:
-                        return node->rotateLeft();
-        }
-        return node;
-}
-
-template <vortex::Comparable T>
-template <typename Comparator>
-        requires vortex::Comparable<T, Comparator>
-Option<const T &> AvlTreeNode<T>::find(const AvlTreeNode *node, const Comparator &searchVal) {
-        if (nullptr == node) {
-                return Option<const T &>();
-        }
-
-        if (node->value == searchVal) {
-                return Option<const T &>(node->value);
-        }
-        if (node->value > searchVal) {
-                return find(node->left, searchVal);
-        }
-        return find(node->right, searchVal);
-}
-
-template <vortex::Comparable T>
-void AvlTreeNode<T>::clone(const AvlTreeNode &other)
-        requires vortex::Cloneable<T>
-{
-        value = other.value.clone();
-        depth = other.depth.clone();
-        if (other.left != nullptr) {
-                left = new AvlTreeNode<T>(*other.left);
-        } else {
-                left = nullptr;
-        }
-        if (other.right != nullptr) {
-                right = new AvlTreeNode<T>(*other.right);
-        } else {
-                right = nullptr;
-        }
-}
+        size_t size() const;
+        bool isEmpty() const;
+};
 
 template <vortex::Comparable T>
-void AvlTreeNode<T>::move(AvlTreeNode &&other) noexcept
-        requires vortex::Moveable<T>
-{
-        value = std::move(other.value);
-        depth = other.depth;
-        left = other.left;
-        right = other.right;
-        other.left = nullptr;
-        other.right = nullptr;
-        other.depth = 0;
+AvlTreeNode<T>::AvlTreeNode(T &&val) : value(std::move(val)) {
 }
 
 template <vortex::Comparable T>
-void AvlTreeNode<T>::free() {
-        delete left;
-        delete right;
-        left = nullptr;
-        right = nullptr;
-        depth = 0;
+AvlTreeNode<T> &AvlTree<T>::node(uint32_t idx) {
+        return nodes.getUnchecked(idx);
 }
 
 template <vortex::Comparable T>
-void AvlTreeNode<T>::safeUpdateDepth(AvlTreeNode<T> *node) {
-        if (node != nullptr) {
-                node->depth = 1 + std::max(node->leftDepth(), node->rightDepth());
-        }
+const AvlTreeNode<T> &AvlTree<T>::node(uint32_t idx) const {
+        return nodes.getUnchecked(idx);
 }
 
 template <vortex::Comparable T>
-unsigned AvlTreeNode<T>::leftDepth() const {
-        if (nullptr == left) {
+unsigned AvlTree<T>::depthOf(uint32_t idx) const {
+        if (idx == NIL) {
                 return 0;
         }
-        return left->depth;
+        return node(idx).depth;
 }
 
 template <vortex::Comparable T>
-unsigned AvlTreeNode<T>::rightDepth() const {
-        if (nullptr == right) {
-                return 0;
-        }
-        return right->depth;
+void AvlTree<T>::updateDepth(uint32_t idx) {
+        Node &current = node(idx);
+        current.depth = 1 + std::max(depthOf(current.left), depthOf(current.right));
 }
 
 template <vortex::Comparable T>
-int AvlTreeNode<T>::depthDiff() const {
-        return static_cast<int>(leftDepth()) - static_cast<int>(rightDepth());
+int AvlTree<T>::depthDiff(uint32_t idx) const {
+        const Node &current = node(idx);
+        return static_cast<int>(depthOf(current.left)) - static_cast<int>(depthOf(current.right));
 }
 
 template <vortex::Comparable T>
-AvlTreeNode<T>::Balance AvlTreeNode<T>::getBalance() const {
-        const int rootDepthDiff = depthDiff();
+AvlTree<T>::Balance AvlTree<T>::getBalance(uint32_t idx) const {
+        const int rootDepthDiff = depthDiff(idx);
         if (std::abs(rootDepthDiff) < 2) {
                 return Balance::Balanced;
         }
 
         if (rootDepthDiff > 1) {
-                const int childDepthDiff = left->depthDiff();
+                const int childDepthDiff = depthDiff(node(idx).left);
                 if (childDepthDiff > 0) {
                         return Balance::LeftLeft;
                 }
                 return Balance::LeftRight;
         }
-        if (rootDepthDiff < -1) {
-                const int childDepthDiff = right->depthDiff();
-                if (childDepthDiff > 0) {
-                        return Balance::RightLeft;
-                }
-                return Balance::RightRight;
+        const int childDepthDiff = depthDiff(node(idx).right);
+        if (childDepthDiff > 0) {
+                return Balance::RightLeft;
         }
         return Balance::RightRight;
 }
 
 template <vortex::Comparable T>
-AvlTreeNode<T> *AvlTreeNode<T>::rotateLeft() {
-        if (nullptr == right) {
-                throw AvlTreeException("Left rotation without a right child node");
+uint32_t AvlTree<T>::rebalance(uint32_t idx) {
+        updateDepth(idx);
+        switch (getBalance(idx)) {
+                case Balance::Balanced:
+                        return idx;
+                case Balance::LeftLeft:
+                        return rotateRight(idx);
+                case Balance::LeftRight:
+                        node(idx).left = rotateLeft(node(idx).left);
+                        return rotateRight(idx);
+                case Balance::RightLeft:
+                        node(idx).right = rotateRight(node(idx).right);
+                        return rotateLeft(idx);
+                case Balance::RightRight:
+                        return rotateLeft(idx);
         }
+        return idx;
+}
 
-        AvlTreeNode *k = right;
-        AvlTreeNode *t2 = k->left;
+template <vortex::Comparable T>
+uint32_t AvlTree<T>::rotateLeft(uint32_t idx) {
+        const uint32_t k = node(idx).right;
+        if (k == NIL) {
+                throw AvlTreeException("Left rotation without a right child node");
+        }
 
-        this->right = t2;
-        k->left = this;
+        node(idx).right = node(k).left;
+        node(k).left = idx;
 
-        safeUpdateDepth(this);
-        safeUpdateDepth(k);
+        updateDepth(idx);
+        updateDepth(k);
         return k;
 }
 
 template <vortex::Comparable T>
-AvlTreeNode<T> *AvlTreeNode<T>::rotateRight() {
-        if (nullptr == left) {
+uint32_t AvlTree<T>::rotateRight(uint32_t idx) {
+        const uint32_t k = node(idx).left;
+        if (k == NIL) {
                 throw AvlTreeException("Right rotation without a left child node");
         }
 
-        AvlTreeNode *k = left;
-        AvlTreeNode *t2 = k->right;
+        node(idx).left = node(k).right;
+        node(k).right = idx;
 
-        this->left = t2;
-        k->right = this;
-
-        safeUpdateDepth(this);
-        safeUpdateDepth(k);
+        updateDepth(idx);
+        updateDepth(k);
         return k;
 }
 
 template <vortex::Comparable T>
-AvlTree<T>::AvlTree(const AvlTree &other)
-        requires vortex::Cloneable<T>
-{
-        copy(other);
+uint32_t AvlTree<T>::link(uint32_t start, uint32_t end) {
+        if (start >= end) {
+                return NIL;
+        }
+        const uint32_t mid = start + (end - start) / 2;
+        Node &current = node(mid);
+        current.left = link(start, mid);
+        current.right = link(mid + 1, end);
+        updateDepth(mid);
+        return mid;
 }
 
 template <vortex::Comparable T>
-AvlTree<T>::AvlTree(AvlTree &&other) noexcept
-        requires vortex::Moveable<T>
-{
-        move(std::move(other));
+AvlTree<T>::AvlTree(size_t capacity) : nodes(capacity) {
 }
 
 template <vortex::Comparable T>
-AvlTree<T>::~AvlTree() {
-        free();
+AvlTree<T>::AvlTree(MemoryResource &resource) : nodes(resource) {
 }
 
 template <vortex::Comparable T>
-AvlTree<T> &AvlTree<T>::operator=(const AvlTree &other)
-        requires vortex::Cloneable<T>
-{
-        if (this != &other) {
-                free();
-                copy(other);
+AvlTree<T> AvlTree<T>::buildFromSorted(Vector<T> &&values) {
+        AvlTree<T> result(values.length());
+        for (T &value : values) {
+                const size_t count = result.nodes.length();
+                if (count > 0 && !(result.node((uint32_t)(count - 1)).value < value)) {
+                        throw AvlTreeException("Building AVL tree out of unsorted values");
+                }
+                result.nodes.emplaceBack(std::move(value));
         }
-        return *this;
+        values.clear();
+        result.root = result.link(0, (uint32_t)result.nodes.length());
+        return result;
 }
 
 template <vortex::Comparable T>
-AvlTree<T> &AvlTree<T>::operator=(AvlTree &&other) noexcept
-        requires vortex::Moveable<T>
-{
-        if (this != &other) {
-                free();
-                move(std::move(other));
+void AvlTree<T>::insert(T value) {
+        uint32_t path[MAX_DEPTH];
+        size_t pathLength = 0;
+
+        uint32_t current = root;
+        while (current != NIL) {
+                path[pathLength++] = current;
+                const Node &visited = node(current);
+                if (value < visited.value) {
+                        current = visited.left;
+                } else if (value > visited.value) {
+                        current = visited.right;
+                } else {
+                        throw AvlTreeException("Inserting a duplicate value inside AVL tree");
+                }
         }
-        return *this;
-}
 
-template <vortex::Comparable T>
-void AvlTree<T>::insert(T value) {
-        root = AvlTreeNode<T>::insert(root, value);
+        // The new node may reallocate the pool, so only indices are held
+        // across it.
+        uint32_t child = (uint32_t)nodes.length();
+        nodes.emplaceBack(std::move(value));
+
+        // Retraces the path, attaching each rebalanced subtree to its parent.
+        // Once a subtree keeps both its root and its depth, the ones above it
+        // are unchanged, so the retrace stops there.
+        while (pathLength > 0) {
+                const uint32_t parent = path[--pathLength];
+                Node &parentNode = node(parent);
+                if (node(child).value < parentNode.value) {
+                        parentNode.left = child;
+                } else {
+                        parentNode.right = child;
+                }
+                const unsigned previousDepth = parentNode.depth;
+                child = rebalance(parent);
+                if (child == parent && node(parent).depth == previousDepth) {
+                        return;
+                }
+        }
+        root = child;
 }
 
 template <vortex::Comparable T>
 template <typename Comparator>
         requires vortex::Comparable<T, Comparator>
 Option<const T &> AvlTree<T>::find(const Comparator &searchVal) const {
-        return AvlTreeNode<T>::find(root, searchVal);
-}
-
-template <vortex::Comparable T>
-void AvlTree<T>::copy(const AvlTree &other)
-        requires vortex::Cloneable<T>
-
-{
-        root = other.root;
+        uint32_t current = root;
+        while (current != NIL) {
+                const Node &visited = node(current);
+                if (visited.value == searchVal) {
+                        return Option<const T &>(visited.value);
+                }
+                current = visited.value > searchVal ? visited.left : visited.right;
+        }
+        return Option<const T &>();
 }
 
 template <vortex::Comparable T>
-void AvlTree<T>::move(AvlTree &&other) noexcept
-        requires vortex::Moveable<T>
-{
-        this->root = other.root;
-        other.root = nullptr;
+size_t AvlTree<T>::size() const {
+        return nodes.length();
 }
 
 template <vortex::Comparable T>
-void AvlTree<T>::free() {
-        delete root;
-        root = nullptr;
+bool AvlTree<T>::isEmpty() const {
+        return size() == 0;
 }
 
 #endif
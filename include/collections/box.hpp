@@ -33,6 +33,9 @@ class Box {
         const T* operator->() const;
 };
 
+template <typename T>
+struct vortex::IsTriviallyRelocatable<Box<T>> : std::true_type {};
+
 template <typename T>
 void Box<T>::free() {
         delete ptr;
@@ -78,12 +81,12 @@ Box<T>& Box<T>::operator=(Box<T>&& other) noexcept {
 
 template <typename T>
 T& Box<T>::operator*() {
-        return ptr;
+        return *ptr;
 }
 
 template <typename T>
 const T& Box<T>::operator*() const {
-        return ptr;
+        return *ptr;
 }
 
 template <typename T>
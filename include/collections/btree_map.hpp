@@ -0,0 +1,631 @@
+#ifndef VORTEX_BTREE_MAP_HPP
+#define VORTEX_BTREE_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "option.hpp"
+#include "traits.hpp"
+#include "vector.hpp"
+
+template <typename T>
+concept OrderedKey = vortex::Comparable<T> && std::copyable<T>;
+
+/// An ordered key-value map, implemented as a B+ tree. Each node holds up to
+/// `NODE_CAPACITY` keys, so the tree is only a few levels deep even for large
+/// key sets and a lookup touches a handful of nodes - compared to one node,
+/// and usually one cache miss, per level of a binary tree. The keys and the
+/// values of a node are kept in separate arrays, so the binary search within a
+/// node only walks over the keys.
+///
+/// The values are stored in the leaves, which are chained in key order, so an
+/// in-order or range iteration is a linear walk over the leaves. The inner
+/// nodes store copies of the separating keys, hence `K` must be copyable.
+///
+/// The copy constructor and `operator=` are deleted for the same reasons as
+/// in `HashMap`.
+template <OrderedKey K, typename V>
+class BTreeMap {
+       public:
+        /// A key-value pair, used for bulk loading the map.
+        class Entry {
+               private:
+                K key;
+                V value;
+
+               public:
+                Entry(K &&k, V &&v) : key(std::move(k)), value(std::move(v)) {
+                }
+
+                friend class BTreeMap;
+        };
+
+        /// A view of an entry inside the map, valid until the map is modified.
+        class EntryRef {
+               private:
+                const K *key;
+                V *value;
+
+               public:
+                EntryRef(const K *k, V *v) : key(k), value(v) {
+                }
+
+                const K &getKey() const {
+                        return *key;
+                }
+
+                V &getValue() const {
+                        return *value;
+                }
+        };
+
+       private:
+        static constexpr size_t NODE_CAPACITY = 32;
+        /// Every node but the root is at least half full, so a tree of this
+        /// depth would not fit in memory.
+        static constexpr size_t MAX_DEPTH = 16;
+
+        struct Node {
+                bool leaf;
+                size_t count = 0;
+                alignas(K) unsigned char keyStorage[NODE_CAPACITY * sizeof(K)];
+
+                Node(bool isLeaf) : leaf(isLeaf) {
+                }
+
+                K *keys() {
+                        return reinterpret_cast<K *>(keyStorage);
+                }
+
+                const K *keys() const {
+                        return reinterpret_cast<const K *>(keyStorage);
+                }
+        };
+
+        struct Leaf : Node {
+                alignas(V) unsigned char valueStorage[NODE_CAPACITY * sizeof(V)];
+                Leaf *next = nullptr;
+
+                Leaf() : Node(true) {
+                }
+
+                V *values() {
+                        return reinterpret_cast<V *>(valueStorage);
+                }
+        };
+
+        /// The child `i + 1` holds the keys, which are not less than the key
+        /// `i`, and the child `i` - the ones less than it.
+        struct Inner : Node {
+                Node *children[NODE_CAPACITY + 1];
+
+                Inner() : Node(false) {
+                }
+        };
+
+       public:
+        class Iterator {
+               private:
+                Leaf *leaf;
+                size_t idx;
+
+               public:
+                Iterator(Leaf *, size_t);
+
+                bool operator==(const Iterator &) const;
+                EntryRef operator*() const;
+                Iterator &operator++();
+        };
+
+        /// The entries between two positions of the map.
+        class Range {
+               private:
+                Iterator first;
+                Iterator last;
+
+               public:
+                Range(Iterator f, Iterator l) : first(f), last(l) {
+                }
+
+                Iterator begin() const {
+                        return first;
+                }
+
+                Iterator end() const {
+                        return last;
+                }
+        };
+
+       private:
+        Node *root = nullptr;
+        size_t elementsCount = 0;
+
+        static void free(Node *);
+        void move(BTreeMap &&) noexcept;
+
+        /// Inserts the element at the given position of the uninitialized
+        /// storage, shifting the following ones to the right.
+        template <typename T>
+        static void insertAt(T *, size_t, size_t, T &&);
+        /// Move-constructs the elements into the uninitialized destination and
+        /// destroys the originals.
+        template <typename T>
+        static void relocate(T *, T *, size_t);
+
+        /// The index of the first key in the node, which is not less than the
+        /// given one.
+        static size_t searchNode(const Node *, const K &);
+        /// The index of the child, whose subtree may contain the given key.
+        static size_t childIndex(const Inner *, const K &);
+
+        Leaf *findLeaf(const K &) const;
+        /// Splits the full leaf in halves and returns the new right half.
+        static Leaf *splitLeaf(Leaf *);
+        /// Inserts the separator and the child right of it at the given key
+        /// index of a node, which is not full.
+        static void insertIntoInner(Inner *, size_t, K &&, Node *);
+        /// Inserts the separator and the child right of it into the node on
+        /// the given level of the path, splitting the full nodes upwards.
+        void insertIntoParent(Inner **, size_t *, size_t, K &&, Node *);
+
+        /// Links the nodes of one level under a new level of inner nodes. The
+        /// smallest key of each node's subtree is passed alongside it.
+        static void buildLevel(Vector<Node *> &, Vector<K> &);
+
+       public:
+        BTreeMap() = default;
+        BTreeMap(const BTreeMap &) = delete;
+        BTreeMap(BTreeMap &&) noexcept;
+        ~BTreeMap();
+
+        BTreeMap &operator=(const BTreeMap &) = delete;
+        BTreeMap &operator=(BTreeMap &&) noexcept;
+
+        /// Builds a map out of entries with strictly ascending keys in O(n).
+        /// The entries are spread evenly across the fewest leaves, which can
+        /// hold them, so every leaf but a lone root is at least half full.
+        /// Throws `std::invalid_argument` if the keys are not strictly
+        /// ascending.
+        static BTreeMap buildFromSorted(Vector<Entry> &&);
+
+        /// Inserts the key with the given value, or replaces the value if the
+        /// key is already present.
+        void insert(K, V);
+        /// Returns a copy of the value. The callers, which do not need to own
+        /// it, should prefer `getRef`.
+        Option<V> get(const K &) const;
+        /// Returns a reference to the value, which is valid until the map is
+        /// modified, instead of copying it.
+        Option<const V &> getRef(const K &) const;
+        Option<V &> getRef(const K &);
+        bool contains(const K &) const;
+
+        size_t size() const;
+        bool isEmpty() const;
+
+        /// The position of the first key, which is not less than the given one.
+        Iterator lowerBound(const K &) const;
+        /// The entries with keys in the half-open range `[from, to)`, in
+        /// ascending order.
+        Range range(const K &, const K &) const;
+
+        /// The entries are iterated in ascending order of their keys.
+        Iterator begin() const;
+        Iterator end() const;
+};
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Iterator::Iterator(Leaf *_leaf, size_t _idx) : leaf(_leaf), idx(_idx) {
+        // A position past the last key of a leaf is the start of the next one,
+        // so that equal positions compare equal.
+        if (leaf != nullptr && idx == leaf->count) {
+                leaf = leaf->next;
+                idx = 0;
+        }
+}
+
+template <OrderedKey K, typename V>
+bool BTreeMap<K, V>::Iterator::operator==(const Iterator &other) const {
+        return leaf == other.leaf && idx == other.idx;
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::EntryRef BTreeMap<K, V>::Iterator::operator*() const {
+        return EntryRef(leaf->keys() + idx, leaf->values() + idx);
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Iterator &BTreeMap<K, V>::Iterator::operator++() {
+        *this = Iterator(leaf, idx + 1);
+        return *this;
+}
+
+template <OrderedKey K, typename V>
+void BTreeMap<K, V>::free(Node *node) {
+        if (nullptr == node) {
+                return;
+        }
+        for (size_t i = 0; i < node->count; ++i) {
+                node->keys()[i].~K();
+        }
+        if (node->leaf) {
+                Leaf *leaf = static_cast<Leaf *>(node);
+                for (size_t i = 0; i < leaf->count; ++i) {
+                        leaf->values()[i].~V();
+                }
+                delete leaf;
+                return;
+        }
+        Inner *inner = static_cast<Inner *>(node);
+        for (size_t i = 0; i <= inner->count; ++i) {
+                free(inner->children[i]);
+        }
+        delete inner;
+}
+
+template <OrderedKey K, typename V>
+void BTreeMap<K, V>::move(BTreeMap &&other) noexcept {
+        this->root = other.root;
+        this->elementsCount = other.elementsCount;
+        other.root = nullptr;
+        other.elementsCount = 0;
+}
+
+template <OrderedKey K, typename V>
+template <typename T>
+void BTreeMap<K, V>::insertAt(T *elements, size_t count, size_t pos, T &&element) {
+        if (pos == count) {
+                new (elements + count) T(std::move(element));
+                return;
+        }
+        new (elements + count) T(std::move(elements[count - 1]));
+        for (size_t i = count - 1; i > pos; --i) {
+                elements[i] = std::move(elements[i - 1]);
+        }
+        elements[pos] = std::move(element);
+}
+
+template <OrderedKey K, typename V>
+template <typename T>
+void BTreeMap<K, V>::relocate(T *dst, T *src, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+                new (dst + i) T(std::move(src[i]));
+                src[i].~T();
+        }
+}
+
+template <OrderedKey K, typename V>
+size_t BTreeMap<K, V>::searchNode(const Node *node, const K &key) {
+        const K *keys = node->keys();
+        size_t low = 0;
+        size_t high = node->count;
+        while (low < high) {
+                const size_t mid = low + (high - low) / 2;
+                if (keys[mid] < key) {
+                        low = mid + 1;
+                } else {
+                        high = mid;
+                }
+        }
+        return low;
+}
+
+template <OrderedKey K, typename V>
+size_t BTreeMap<K, V>::childIndex(const Inner *inner, const K &key) {
+        const size_t idx = searchNode(inner, key);
+        // A key equal to the separator belongs to the right subtree.
+        if (idx < inner->count && inner->keys()[idx] == key) {
+                return idx + 1;
+        }
+        return idx;
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Leaf *BTreeMap<K, V>::findLeaf(const K &key) const {
+        if (nullptr == root) {
+                return nullptr;
+        }
+        Node *node = root;
+        while (!node->leaf) {
+                const Inner *inner = static_cast<const Inner *>(node);
+                node = inner->children[childIndex(inner, key)];
+        }
+        return static_cast<Leaf *>(node);
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Leaf *BTreeMap<K, V>::splitLeaf(Leaf *leaf) {
+        const size_t half = leaf->count / 2;
+        const size_t moved = leaf->count - half;
+        Leaf *right = new Leaf();
+        relocate(right->keys(), leaf->keys() + half, moved);
+        relocate(right->values(), leaf->values() + half, moved);
+        right->count = moved;
+        leaf->count = half;
+        right->next = leaf->next;
+        leaf->next = right;
+        return right;
+}
+
+template <OrderedKey K, typename V>
+void BTreeMap<K, V>::insertIntoInner(Inner *inner, size_t pos, K &&separator, Node *child) {
+        insertAt(inner->keys(), inner->count, pos, std::move(separator));
+        for (size_t i = inner->count + 1; i > pos + 1; --i) {
+                inner->children[i] = inner->children[i - 1];
+        }
+        inner->children[pos + 1] = child;
+        inner->count += 1;
+}
+
+template <OrderedKey K, typename V>
+void BTreeMap<K, V>::insertIntoParent(Inner **path, size_t *pathIdx, size_t level, K &&separator,
+                                      Node *child) {
+        if (level == 0) {
+                // The root was split, so the tree grows by a level.
+                Inner *newRoot = new Inner();
+                new (newRoot->keys()) K(std::move(separator));
+                newRoot->children[0] = root;
+                newRoot->children[1] = child;
+                newRoot->count = 1;
+                root = newRoot;
+                return;
+        }
+
+        Inner *parent = path[level - 1];
+        const size_t pos = pathIdx[level - 1];
+        if (parent->count < NODE_CAPACITY) {
+                insertIntoInner(parent, pos, std::move(separator), child);
+                return;
+        }
+
+        // The keys of the full node together with the new separator are split
+        // around the middle one, which moves up a level.
+        const size_t half = (NODE_CAPACITY + 1) / 2;
+        Inner *right = new Inner();
+        const size_t promotedIdx = pos < half ? half - 1 : half;
+        K promoted = pos == half ? std::move(separator) : std::move(parent->keys()[promotedIdx]);
+        if (pos < half) {
+                relocate(right->keys(), parent->keys() + half, NODE_CAPACITY - half);
+                std::copy(parent->children + half, parent->children + NODE_CAPACITY + 1,
+                          right->children);
+                right->count = NODE_CAPACITY - half;
+                parent->keys()[half - 1].~K();
+                parent->count = half - 1;
+                insertIntoInner(parent, pos, std::move(separator), child);
+        } else if (pos == half) {
+                relocate(right->keys(), parent->keys() + half, NODE_CAPACITY - half);
+                right->children[0] = child;
+                std::copy(parent->children + half + 1, parent->children + NODE_CAPACITY + 1,
+                          right->children + 1);
+                right->count = NODE_CAPACITY - half;
+                parent->count = half;
+        } else {
+                relocate(right->keys(), parent->keys() + half + 1, NODE_CAPACITY - half - 1);
+                std::copy(parent->children + half + 1, parent->children + NODE_CAPACITY + 1,
+                          right->children);
+                right->count = NODE_CAPACITY - half - 1;
+                parent->keys()[half].~K();
+                parent->count = half;
+                insertIntoInner(right, pos - half - 1, std::move(separator), child);
+        }
+        insertIntoParent(path, pathIdx, level - 1, std::move(promoted), right);
+}
+
+template <OrderedKey K, typename V>
+void BTreeMap<K, V>::buildLevel(Vector<Node *> &nodes, Vector<K> &minKeys) {
+        // The children are spread evenly, so no node of the level is left
+        // nearly empty.
+        const size_t childCount = nodes.length();
+        const size_t parentCount = (childCount + NODE_CAPACITY) / (NODE_CAPACITY + 1);
+        Vector<Node *> parents(parentCount);
+        Vector<K> parentMinKeys(parentCount);
+
+        size_t child = 0;
+        for (size_t i = 0; i < parentCount; ++i) {
+                const size_t end = childCount * (i + 1) / parentCount;
+                Inner *inner = new Inner();
+                inner->children[0] = nodes[child].unwrap();
+                parentMinKeys.pushBack(minKeys[child].unwrap());
+                for (size_t j = child + 1; j < end; ++j) {
+                        new (inner->keys() + inner->count) K(std::move(minKeys[j].unwrap()));
+                        inner->count += 1;
+                        inner->children[inner->count] = nodes[j].unwrap();
+                }
+                parents.pushBack(inner);
+                child = end;
+        }
+        nodes = std::move(parents);
+        minKeys = std::move(parentMinKeys);
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::BTreeMap(BTreeMap &&other) noexcept {
+        move(std::move(other));
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::~BTreeMap() {
+        free(root);
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V> &BTreeMap<K, V>::operator=(BTreeMap &&other) noexcept {
+        if (this != &other) {
+                free(root);
+                move(std::move(other));
+        }
+        return *this;
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V> BTreeMap<K, V>::buildFromSorted(Vector<Entry> &&entries) {
+        BTreeMap<K, V> result;
+        const size_t count = entries.length();
+        if (count == 0) {
+                return result;
+        }
+        for (size_t i = 1; i < count; ++i) {
+                if (!(entries[i - 1].unwrap().key < entries[i].unwrap().key)) {
+                        throw std::invalid_argument("Building B-tree out of unsorted keys");
+                }
+        }
+
+        const size_t leafCount = (count + NODE_CAPACITY - 1) / NODE_CAPACITY;
+        Vector<Node *> nodes(leafCount);
+        Vector<K> minKeys(leafCount);
+        Leaf *previous = nullptr;
+        size_t entry = 0;
+        for (size_t i = 0; i < leafCount; ++i) {
+                const size_t end = count * (i + 1) / leafCount;
+                Leaf *leaf = new Leaf();
+                minKeys.pushBack(entries[entry].unwrap().key);
+                for (; entry < end; ++entry) {
+                        Entry &moved = entries[entry].unwrap();
+                        new (leaf->keys() + leaf->count) K(std::move(moved.key));
+                        new (leaf->values() + leaf->count) V(std::move(moved.value));
+                        leaf->count += 1;
+                }
+                if (previous != nullptr) {
+                        previous->next = leaf;
+                }
+                previous = leaf;
+                nodes.pushBack(leaf);
+        }
+        entries.clear();
+
+        while (nodes.length() > 1) {
+                buildLevel(nodes, minKeys);
+        }
+        result.root = nodes[0].unwrap();
+        result.elementsCount = count;
+        return result;
+}
+
+template <OrderedKey K, typename V>
+void BTreeMap<K, V>::insert(K key, V value) {
+        if (nullptr == root) {
+                root = new Leaf();
+        }
+
+        // The path from the root, along with the index of the followed child
+        // in each node, is kept for splitting the full nodes on the way back.
+        Inner *path[MAX_DEPTH];
+        size_t pathIdx[MAX_DEPTH];
+        size_t depth = 0;
+        Node *node = root;
+        while (!node->leaf) {
+                Inner *inner = static_cast<Inner *>(node);
+                const size_t idx = childIndex(inner, key);
+                path[depth] = inner;
+                pathIdx[depth] = idx;
+                depth += 1;
+                node = inner->children[idx];
+        }
+
+        Leaf *leaf = static_cast<Leaf *>(node);
+        size_t pos = searchNode(leaf, key);
+        if (pos < leaf->count && leaf->keys()[pos] == key) {
+                leaf->values()[pos] = std::move(value);
+                return;
+        }
+
+        if (leaf->count == NODE_CAPACITY) {
+                Leaf *right = splitLeaf(leaf);
+                if (pos > leaf->count) {
+                        pos -= leaf->count;
+                        leaf = right;
+                }
+                insertIntoParent(path, pathIdx, depth, K(right->keys()[0]), right);
+        }
+        insertAt(leaf->keys(), leaf->count, pos, std::move(key));
+        insertAt(leaf->values(), leaf->count, pos, std::move(value));
+        leaf->count += 1;
+        elementsCount += 1;
+}
+
+template <OrderedKey K, typename V>
+Option<V> BTreeMap<K, V>::get(const K &key) const {
+        const Option<const V &> value = getRef(key);
+        if (value.isNone()) {
+                return Option<V>();
+        }
+        return Option<V>(value.unwrap());
+}
+
+template <OrderedKey K, typename V>
+Option<const V &> BTreeMap<K, V>::getRef(const K &key) const {
+        Leaf *leaf = findLeaf(key);
+        if (nullptr == leaf) {
+                return Option<const V &>();
+        }
+        const size_t pos = searchNode(leaf, key);
+        if (pos == leaf->count || !(leaf->keys()[pos] == key)) {
+                return Option<const V &>();
+        }
+        return Option<const V &>(leaf->values()[pos]);
+}
+
+template <OrderedKey K, typename V>
+Option<V &> BTreeMap<K, V>::getRef(const K &key) {
+        const Option<const V &> value = static_cast<const BTreeMap &>(*this).getRef(key);
+        if (value.isNone()) {
+                return Option<V &>();
+        }
+        return Option<V &>(const_cast<V &>(value.unwrap()));
+}
+
+template <OrderedKey K, typename V>
+bool BTreeMap<K, V>::contains(const K &key) const {
+        return getRef(key).isSome();
+}
+
+template <OrderedKey K, typename V>
+size_t BTreeMap<K, V>::size() const {
+        return elementsCount;
+}
+
+template <OrderedKey K, typename V>
+bool BTreeMap<K, V>::isEmpty() const {
+        return size() == 0;
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Iterator BTreeMap<K, V>::lowerBound(const K &key) const {
+        Leaf *leaf = findLeaf(key);
+        if (nullptr == leaf) {
+                return end();
+        }
+        return Iterator(leaf, searchNode(leaf, key));
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Range BTreeMap<K, V>::range(const K &from, const K &to) const {
+        if (!(from < to)) {
+                return Range(end(), end());
+        }
+        return Range(lowerBound(from), lowerBound(to));
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Iterator BTreeMap<K, V>::begin() const {
+        if (nullptr == root) {
+                return end();
+        }
+        Node *node = root;
+        while (!node->leaf) {
+                node = static_cast<Inner *>(node)->children[0];
+        }
+        return Iterator(static_cast<Leaf *>(node), 0);
+}
+
+template <OrderedKey K, typename V>
+BTreeMap<K, V>::Iterator BTreeMap<K, V>::end() const {
+        return Iterator(nullptr, 0);
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef VORTEX_HASH_H
+#define VORTEX_HASH_H
+
+#include <cstddef>
+
+namespace vortex {
+
+/// Hashes a sequence of bytes. The bytes are consumed a word at a time and
+/// mixed through 64x64->128 bit multiplications in the style of wyhash, which
+/// spreads the entropy of each byte across the whole result - unlike the
+/// traditional byte-at-a-time polynomial hashes, which are both slower and
+/// leave the low bits poorly distributed.
+size_t hashBytes(const char *, size_t);
+
+}  // namespace vortex
+
+#endif
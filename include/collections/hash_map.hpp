@@ -1,15 +1,37 @@
 #ifndef VORTEX_HASH_MAP_HPP
 #define VORTEX_HASH_MAP_HPP
 
-#include "collections/avl.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "memory_resource.h"
 #include "option.hpp"
+#include "string.h"
 #include "traits.hpp"
-#include "vector.hpp"
+
+class HashMapException : public std::exception {
+       protected:
+        String message;
+
+       public:
+        HashMapException(const String &);
+
+        virtual const char *what() const noexcept override;
+};
 
 template <typename T>
 concept Key = vortex::Hashable<T> && vortex::Equatable<T>;
 
-/// A simple key-value map structure. The type `K` must implement the
+/// A key-value map structure. The type `K` must either derive from
+/// `vortex::Hash`, provide a `hash` method of its own or implement the
 /// `std::hash<K>` template specialization and is implied that the type can be
 /// compared via the `operator==`.
 ///
@@ -17,133 +39,434 @@ concept Key = vortex::Hashable<T> && vortex::Equatable<T>;
 /// cloning, which given that `K` is not type-bound to a custom `Cloneable`
 /// concept, should not rely on an arbitrary means of deeply copying data.
 ///
-/// This implementation follows the general structure of a `HashMap`, but
-/// instead of using AVL trees for the individual bucket stores, it uses Singly
-/// Linked Lists (SLL), which provide less time complexity amortization, but
-/// still good enough performance.
+/// The map is an open-addressing hash table in the style of the Swiss tables.
+/// Next to the entries it keeps an array of control bytes - one per slot -
+/// which holds 7 bits of the hash of a present key, or marks the slot as empty
+/// or deleted. A lookup scans the control bytes of a whole group of 16 slots at
+/// once (with SSE2, where available) and only compares the keys, whose 7 bits
+/// match. The table grows once it is 7/8 full, so the lookups stay O(1).
+///
+/// Besides a `K`, the lookups accept any type, for which `vortex::KeyLookup`
+/// is specialized - such as a `StringView` or a C string for the `String`
+/// keys - so the caller does not need to build a temporary key.
 template <Key K, typename V>
 class HashMap {
-       private:
-        static constexpr size_t DEFAULT_BUCKETS = 16;
-
-        struct Entry : public vortex::Compare<Entry>, public vortex::Compare<K> {
+       public:
+        class Entry {
                private:
                 K key;
                 V value;
 
                public:
-                Entry(K k, V v) : key(k), value(v) {
+                Entry(K &&k, V &&v) : key(std::move(k)), value(std::move(v)) {
                 }
 
-                virtual vortex::Ordering compare(const Entry &other) const override {
-                        return key.compare(other.getKey());
+                const K &getKey() const {
+                        return key;
                 }
 
-                virtual vortex::Ordering compare(const K &other) const override {
-                        return key.compare(other);
+                const V &getValue() const {
+                        return value;
                 }
 
-                friend bool operator<(const Entry &lhs, const Entry &rhs) {
-                        return lhs.compare(rhs) == vortex::Ordering::Less;
+                V &getValue() {
+                        return value;
                 }
 
-                friend bool operator>(const Entry &lhs, const Entry &rhs) {
-                        return lhs.compare(rhs) == vortex::Ordering::Greater;
-                }
+                friend class HashMap;
+        };
 
-                friend bool operator==(const Entry &lhs, const Entry &rhs) {
-                        return lhs.compare(rhs) == vortex::Ordering::Equal;
-                }
+       private:
+        /// Iterates the entries of a mutable map, or only views them if
+        /// `Const` is set.
+        template <bool Const>
+        class Iterator {
+               public:
+                using EntryType = std::conditional_t<Const, const Entry, Entry>;
 
-                friend bool operator<(const Entry &lhs, const K &rhs) {
-                        return lhs.getKey().compare(rhs) == vortex::Ordering::Less;
-                }
+               private:
+                const int8_t *ctrl;
+                EntryType *slot;
+                EntryType *end;
 
-                friend bool operator>(const Entry &lhs, const K &rhs) {
-                        return lhs.getKey().compare(rhs) == vortex::Ordering::Greater;
-                }
+                void skipEmpty();
 
-                friend bool operator==(const Entry &lhs, const K &rhs) {
-                        return lhs.getKey().compare(rhs) == vortex::Ordering::Equal;
-                }
+               public:
+                Iterator(const int8_t *, EntryType *, EntryType *);
 
-                const K &getKey() const {
-                        return key;
-                }
+                bool operator==(const Iterator &) const;
+                EntryType &operator*() const;
+                Iterator &operator++();
+        };
 
-                const V &getValue() const {
-                        return value;
-                }
+        /// The control bytes of a group of consecutive slots, matched at once.
+        class Group {
+               private:
+                const int8_t *ctrl;
+
+               public:
+                Group(const int8_t *);
+
+                /// A bit mask of the slots, whose control byte equals the given
+                /// one.
+                uint32_t match(int8_t) const;
+                uint32_t matchEmpty() const;
+                /// Empty and deleted slots are the only ones with the highest
+                /// bit set.
+                uint32_t matchEmptyOrDeleted() const;
         };
 
        private:
+        static constexpr size_t GROUP_WIDTH = 16;
+        static constexpr int8_t EMPTY = -128;
+        static constexpr int8_t DELETED = -2;
+
+        int8_t *ctrl = nullptr;
+        Entry *slots = nullptr;
+        size_t capacity = 0;
         size_t elementsCount = 0;
-        Vector<AvlTree<Entry>> buckets;
+        /// The number of insertions into empty slots left before the table
+        /// grows. Reusing deleted slots does not consume it.
+        size_t growthLeft = 0;
+        /// The source of the table, or `nullptr` for the heap.
+        MemoryResource *resource = nullptr;
+
+        static size_t mix(size_t);
+        static int8_t h2(size_t);
+        static size_t maxLoad(size_t);
 
         void free();
         void move(HashMap &&) noexcept;
-        size_t getBucketIndex(const K &) const;
+        /// Releases the control bytes and the slots of a table with the given
+        /// capacity.
+        void deallocate(int8_t *, Entry *, size_t);
+        /// Moves all entries to a table with the given capacity, which is a
+        /// multiple of `GROUP_WIDTH` and a power of two.
+        void rehash(size_t);
+
+        /// Returns the slot index of the key, if it is present.
+        template <typename Q>
+        Option<size_t> findSlot(const Q &, size_t) const;
+        /// Returns the first empty or deleted slot along the probe sequence.
+        size_t findInsertSlot(size_t) const;
+        /// Destroys the entry in the slot and releases the slot.
+        void eraseSlot(size_t);
+        /// Inserts a key, which is known to be absent, with its mixed hash.
+        void insertNew(K &&, V &&, size_t);
 
        public:
         HashMap();
+        /// Builds a map with enough capacity for the given number of elements.
         HashMap(size_t);
+        /// Builds a map, whose table is allocated from the given resource.
+        HashMap(MemoryResource &);
+        HashMap(size_t, MemoryResource &);
         HashMap(const HashMap &) = delete;
         HashMap(HashMap &&) noexcept;
+        ~HashMap();
 
         HashMap &operator=(const HashMap &) = delete;
         HashMap &operator=(HashMap &&) noexcept;
 
+        /// Inserts the key with the given value. Throws `HashMapException` if
+        /// the key is already present.
         void insert(K, V);
+        /// Inserts the key with the given value, or replaces the value if the
+        /// key is already present.
+        void insertOrAssign(K, V);
+        /// Returns a copy of the value. The callers, which do not need to own
+        /// it, should prefer `getRef`.
         Option<V> get(const K &) const;
+        template <typename Q>
+                requires vortex::LookupKey<K, Q>
+        Option<V> get(const Q &) const;
+        /// Returns a reference to the value, which is valid until the map is
+        /// modified, instead of copying it.
+        Option<const V &> getRef(const K &) const;
+        template <typename Q>
+                requires vortex::LookupKey<K, Q>
+        Option<const V &> getRef(const Q &) const;
+        Option<V &> getRef(const K &);
+        template <typename Q>
+                requires vortex::LookupKey<K, Q>
+        Option<V &> getRef(const Q &);
         bool contains(const K &) const;
-
-        /// Returns the total number of elements, present across all buckets
-        /// inside the `HashMap`.
+        template <typename Q>
+                requires vortex::LookupKey<K, Q>
+        bool contains(const Q &) const;
+        /// Removes the key from the map. Returns whether it was present.
+        bool erase(const K &);
+        template <typename Q>
+                requires vortex::LookupKey<K, Q>
+        bool erase(const Q &);
+        /// Removes the key from the map and moves its value out.
+        Option<V> remove(const K &);
+        template <typename Q>
+                requires vortex::LookupKey<K, Q>
+        Option<V> remove(const Q &);
+        /// Ensures that the given number of elements fits without growing.
+        void reserve(size_t);
+
+        /// Returns the total number of elements inside the `HashMap`.
         size_t size() const;
         bool isEmpty() const;
+
+        /// The entries are iterated in an unspecified order. Only the values
+        /// of a mutable map can be modified through its entries.
+        Iterator<false> begin();
+        Iterator<false> end();
+        Iterator<true> begin() const;
+        Iterator<true> end() const;
 };
 
+template <Key K, typename V>
+template <bool Const>
+HashMap<K, V>::Iterator<Const>::Iterator(const int8_t *_ctrl, EntryType *_slot, EntryType *_end)
+    : ctrl(_ctrl), slot(_slot), end(_end) {
+        skipEmpty();
+}
+
+template <Key K, typename V>
+template <bool Const>
+void HashMap<K, V>::Iterator<Const>::skipEmpty() {
+        while (slot != end && *ctrl < 0) {
+                ++ctrl;
+                ++slot;
+        }
+}
+
+template <Key K, typename V>
+template <bool Const>
+bool HashMap<K, V>::Iterator<Const>::operator==(const Iterator &other) const {
+        return slot == other.slot;
+}
+
+template <Key K, typename V>
+template <bool Const>
+HashMap<K, V>::Iterator<Const>::EntryType &HashMap<K, V>::Iterator<Const>::operator*() const {
+        return *slot;
+}
+
+template <Key K, typename V>
+template <bool Const>
+HashMap<K, V>::Iterator<Const> &HashMap<K, V>::Iterator<Const>::operator++() {
+        ++ctrl;
+        ++slot;
+        skipEmpty();
+        return *this;
+}
+
+template <Key K, typename V>
+HashMap<K, V>::Group::Group(const int8_t *_ctrl) : ctrl(_ctrl) {
+}
+
+#if defined(__SSE2__)
+
+template <Key K, typename V>
+uint32_t HashMap<K, V>::Group::match(int8_t byte) const {
+        const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(byte)));
+}
+
+template <Key K, typename V>
+uint32_t HashMap<K, V>::Group::matchEmptyOrDeleted() const {
+        const __m128i group = _mm_load_si128(reinterpret_cast<const __m128i *>(ctrl));
+        return (uint32_t)_mm_movemask_epi8(group);
+}
+
+#else
+
+template <Key K, typename V>
+uint32_t HashMap<K, V>::Group::match(int8_t byte) const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= (uint32_t)(ctrl[i] == byte) << i;
+        }
+        return mask;
+}
+
+template <Key K, typename V>
+uint32_t HashMap<K, V>::Group::matchEmptyOrDeleted() const {
+        uint32_t mask = 0;
+        for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+                mask |= (uint32_t)(ctrl[i] < 0) << i;
+        }
+        return mask;
+}
+
+#endif
+
+template <Key K, typename V>
+uint32_t HashMap<K, V>::Group::matchEmpty() const {
+        return match(EMPTY);
+}
+
+template <Key K, typename V>
+size_t HashMap<K, V>::mix(size_t raw) {
+        // The hashes of some types (such as the integers) are weak in their
+        // lower bits, which choose the group, so they are mixed beforehand.
+        uint64_t hash = (uint64_t)raw;
+        hash ^= hash >> 33;
+        hash *= 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 33;
+        return (size_t)hash;
+}
+
+template <Key K, typename V>
+int8_t HashMap<K, V>::h2(size_t hash) {
+        return (int8_t)(hash & 0x7F);
+}
+
+template <Key K, typename V>
+size_t HashMap<K, V>::maxLoad(size_t capacity) {
+        return capacity - capacity / 8;
+}
+
 template <Key K, typename V>
 void HashMap<K, V>::free() {
+        if (nullptr == ctrl) {
+                return;
+        }
+        if constexpr (!std::is_trivially_destructible_v<Entry>) {
+                for (size_t i = 0; i < capacity; ++i) {
+                        if (ctrl[i] >= 0) {
+                                slots[i].~Entry();
+                        }
+                }
+        }
+        deallocate(ctrl, slots, capacity);
+        ctrl = nullptr;
+        slots = nullptr;
+        capacity = 0;
         elementsCount = 0;
-        buckets.~Vector();
+        growthLeft = 0;
 }
 
 template <Key K, typename V>
 void HashMap<K, V>::move(HashMap<K, V> &&other) noexcept {
+        this->ctrl = other.ctrl;
+        this->slots = other.slots;
+        this->capacity = other.capacity;
         this->elementsCount = other.elementsCount;
-        this->buckets = std::move(other.buckets);
+        this->growthLeft = other.growthLeft;
+        this->resource = other.resource;
+        other.ctrl = nullptr;
+        other.slots = nullptr;
+        other.capacity = 0;
         other.elementsCount = 0;
+        other.growthLeft = 0;
+}
+
+template <Key K, typename V>
+void HashMap<K, V>::deallocate(int8_t *oldCtrl, Entry *oldSlots, size_t oldCapacity) {
+        MemoryResource::deallocate(resource, oldCtrl, oldCapacity, GROUP_WIDTH);
+        MemoryResource::deallocate(resource, oldSlots, oldCapacity * sizeof(Entry), alignof(Entry));
 }
 
 template <Key K, typename V>
-size_t HashMap<K, V>::getBucketIndex(const K &key) const {
-        return hash(key) % buckets.length();
+void HashMap<K, V>::rehash(size_t newCapacity) {
+        int8_t *const oldCtrl = ctrl;
+        Entry *const oldSlots = slots;
+        const size_t oldCapacity = capacity;
+
+        ctrl = static_cast<int8_t *>(MemoryResource::allocate(resource, newCapacity, GROUP_WIDTH));
+        slots = static_cast<Entry *>(
+            MemoryResource::allocate(resource, newCapacity * sizeof(Entry), alignof(Entry)));
+        capacity = newCapacity;
+        growthLeft = maxLoad(newCapacity) - elementsCount;
+        (void)memset(ctrl, (unsigned char)EMPTY, newCapacity);
+
+        if (nullptr == oldCtrl) {
+                return;
+        }
+        for (size_t i = 0; i < oldCapacity; ++i) {
+                if (oldCtrl[i] < 0) {
+                        continue;
+                }
+                const size_t hash = mix(vortex::hash(oldSlots[i].key));
+                const size_t slot = findInsertSlot(hash);
+                ctrl[slot] = h2(hash);
+                new (slots + slot) Entry(std::move(oldSlots[i]));
+                oldSlots[i].~Entry();
+        }
+        deallocate(oldCtrl, oldSlots, oldCapacity);
 }
 
 template <Key K, typename V>
-HashMap<K, V>::HashMap() : HashMap(DEFAULT_BUCKETS) {
-        for (size_t i = 0; i < DEFAULT_BUCKETS; i++) {
-                buckets.pushBack(AvlTree<Entry>());
+template <typename Q>
+Option<size_t> HashMap<K, V>::findSlot(const Q &key, size_t hash) const {
+        if (capacity == 0) {
+                return Option<size_t>();
+        }
+        // The groups are probed quadratically, which for a power of two number
+        // of groups visits each of them exactly once.
+        const size_t groupMask = capacity / GROUP_WIDTH - 1;
+        size_t group = (hash >> 7) & groupMask;
+        for (size_t probe = 1; probe <= groupMask + 1; ++probe) {
+                const size_t base = group * GROUP_WIDTH;
+                const Group controls(ctrl + base);
+                for (uint32_t matches = controls.match(h2(hash)); matches != 0;
+                     matches &= matches - 1) {
+                        const size_t slot = base + (size_t)__builtin_ctz(matches);
+                        if (vortex::KeyLookup<K, Q>::equals(slots[slot].key, key)) {
+                                return Option<size_t>(slot);
+                        }
+                }
+                if (controls.matchEmpty() != 0) {
+                        break;
+                }
+                group = (group + probe) & groupMask;
         }
+        return Option<size_t>();
 }
 
 template <Key K, typename V>
-HashMap<K, V>::HashMap(size_t bucketsCount) : buckets(bucketsCount) {
-        for (size_t i = 0; i < bucketsCount; i++) {
-                buckets.pushBack(AvlTree<Entry>());
+size_t HashMap<K, V>::findInsertSlot(size_t hash) const {
+        const size_t groupMask = capacity / GROUP_WIDTH - 1;
+        size_t group = (hash >> 7) & groupMask;
+        for (size_t probe = 1;; ++probe) {
+                const size_t base = group * GROUP_WIDTH;
+                const uint32_t available = Group(ctrl + base).matchEmptyOrDeleted();
+                if (available != 0) {
+                        return base + (size_t)__builtin_ctz(available);
+                }
+                group = (group + probe) & groupMask;
         }
 }
 
+template <Key K, typename V>
+HashMap<K, V>::HashMap() {
+}
+
+template <Key K, typename V>
+HashMap<K, V>::HashMap(size_t expectedElements) {
+        reserve(expectedElements);
+}
+
+template <Key K, typename V>
+HashMap<K, V>::HashMap(MemoryResource &_resource) : resource(&_resource) {
+}
+
+template <Key K, typename V>
+HashMap<K, V>::HashMap(size_t expectedElements, MemoryResource &_resource)
+    : resource(&_resource) {
+        reserve(expectedElements);
+}
+
 template <Key K, typename V>
 HashMap<K, V>::HashMap(HashMap &&other) noexcept {
-        move(other);
+        move(std::move(other));
+}
+
+template <Key K, typename V>
+HashMap<K, V>::~HashMap() {
+        free();
 }
 
 template <Key K, typename V>
 HashMap<K, V> &HashMap<K, V>::operator=(HashMap &&other) noexcept {
         if (this != &other) {
-                this->~HashMap();
+                free();
                 move(std::move(other));
         }
         return *this;
@@ -151,24 +474,161 @@ HashMap<K, V> &HashMap<K, V>::operator=(HashMap &&other) noexcept {
 
 template <Key K, typename V>
 void HashMap<K, V>::insert(K key, V value) {
+        const size_t hash = mix(vortex::hash(key));
+        if (findSlot(key, hash).isSome()) {
+                throw HashMapException("Inserting a key, which is already present");
+        }
+        insertNew(std::move(key), std::move(value), hash);
+}
+
+template <Key K, typename V>
+void HashMap<K, V>::insertOrAssign(K key, V value) {
+        const size_t hash = mix(vortex::hash(key));
+        const Option<size_t> existing = findSlot(key, hash);
+        if (existing.isSome()) {
+                slots[existing.unwrap()].value = std::move(value);
+                return;
+        }
+        insertNew(std::move(key), std::move(value), hash);
+}
+
+template <Key K, typename V>
+void HashMap<K, V>::insertNew(K &&key, V &&value, size_t hash) {
+        if (growthLeft == 0) {
+                // A table clogged by deleted slots is cleaned up in place,
+                // otherwise it doubles.
+                const bool mostlyDeleted = elementsCount < maxLoad(capacity) / 2;
+                rehash(capacity == 0 ? GROUP_WIDTH : mostlyDeleted ? capacity : capacity * 2);
+        }
+        const size_t slot = findInsertSlot(hash);
+        if (ctrl[slot] == EMPTY) {
+                growthLeft -= 1;
+        }
+        ctrl[slot] = h2(hash);
+        new (slots + slot) Entry(std::move(key), std::move(value));
         elementsCount += 1;
-        const size_t index = getBucketIndex(key);
-        buckets[index].unwrap().insert(Entry(key, value));
 }
 
 template <Key K, typename V>
 Option<V> HashMap<K, V>::get(const K &key) const {
-        const size_t index = getBucketIndex(key);
-        Option<const Entry &> entry = buckets[index].unwrap().find(key);
-        if (entry.isNone()) {
+        return get<K>(key);
+}
+
+template <Key K, typename V>
+template <typename Q>
+        requires vortex::LookupKey<K, Q>
+Option<V> HashMap<K, V>::get(const Q &key) const {
+        const Option<size_t> slot = findSlot(key, mix(vortex::KeyLookup<K, Q>::hash(key)));
+        if (slot.isNone()) {
                 return Option<V>();
         }
-        return Option<V>(entry.unwrap().getValue());
+        return Option<V>(slots[slot.unwrap()].value);
+}
+
+template <Key K, typename V>
+Option<const V &> HashMap<K, V>::getRef(const K &key) const {
+        return getRef<K>(key);
+}
+
+template <Key K, typename V>
+template <typename Q>
+        requires vortex::LookupKey<K, Q>
+Option<const V &> HashMap<K, V>::getRef(const Q &key) const {
+        const Option<size_t> slot = findSlot(key, mix(vortex::KeyLookup<K, Q>::hash(key)));
+        if (slot.isNone()) {
+                return Option<const V &>();
+        }
+        return Option<const V &>(slots[slot.unwrap()].value);
+}
+
+template <Key K, typename V>
+Option<V &> HashMap<K, V>::getRef(const K &key) {
+        return getRef<K>(key);
+}
+
+template <Key K, typename V>
+template <typename Q>
+        requires vortex::LookupKey<K, Q>
+Option<V &> HashMap<K, V>::getRef(const Q &key) {
+        const Option<size_t> slot = findSlot(key, mix(vortex::KeyLookup<K, Q>::hash(key)));
+        if (slot.isNone()) {
+                return Option<V &>();
+        }
+        return Option<V &>(slots[slot.unwrap()].value);
 }
 
 template <Key K, typename V>
 bool HashMap<K, V>::contains(const K &key) const {
-        return get(key).isSome();
+        return contains<K>(key);
+}
+
+template <Key K, typename V>
+template <typename Q>
+        requires vortex::LookupKey<K, Q>
+bool HashMap<K, V>::contains(const Q &key) const {
+        return findSlot(key, mix(vortex::KeyLookup<K, Q>::hash(key))).isSome();
+}
+
+template <Key K, typename V>
+bool HashMap<K, V>::erase(const K &key) {
+        return erase<K>(key);
+}
+
+template <Key K, typename V>
+template <typename Q>
+        requires vortex::LookupKey<K, Q>
+bool HashMap<K, V>::erase(const Q &key) {
+        const Option<size_t> found = findSlot(key, mix(vortex::KeyLookup<K, Q>::hash(key)));
+        if (found.isNone()) {
+                return false;
+        }
+        eraseSlot(found.unwrap());
+        return true;
+}
+
+template <Key K, typename V>
+Option<V> HashMap<K, V>::remove(const K &key) {
+        return remove<K>(key);
+}
+
+template <Key K, typename V>
+template <typename Q>
+        requires vortex::LookupKey<K, Q>
+Option<V> HashMap<K, V>::remove(const Q &key) {
+        const Option<size_t> found = findSlot(key, mix(vortex::KeyLookup<K, Q>::hash(key)));
+        if (found.isNone()) {
+                return Option<V>();
+        }
+        Option<V> result(std::move(slots[found.unwrap()].value));
+        eraseSlot(found.unwrap());
+        return result;
+}
+
+template <Key K, typename V>
+void HashMap<K, V>::eraseSlot(size_t slot) {
+        slots[slot].~Entry();
+        elementsCount -= 1;
+
+        // The lookups stop at the first group with an empty slot, so the slot
+        // can only become empty again if its group already stops them.
+        const size_t base = slot - slot % GROUP_WIDTH;
+        if (Group(ctrl + base).matchEmpty() != 0) {
+                ctrl[slot] = EMPTY;
+                growthLeft += 1;
+        } else {
+                ctrl[slot] = DELETED;
+        }
+}
+
+template <Key K, typename V>
+void HashMap<K, V>::reserve(size_t expectedElements) {
+        size_t newCapacity = GROUP_WIDTH;
+        while (maxLoad(newCapacity) < expectedElements) {
+                newCapacity *= 2;
+        }
+        if (newCapacity > capacity) {
+                rehash(newCapacity);
+        }
 }
 
 template <Key K, typename V>
@@ -181,4 +641,24 @@ bool HashMap<K, V>::isEmpty() const {
         return size() == 0;
 }
 
+template <Key K, typename V>
+HashMap<K, V>::Iterator<false> HashMap<K, V>::begin() {
+        return Iterator<false>(ctrl, slots, slots + capacity);
+}
+
+template <Key K, typename V>
+HashMap<K, V>::Iterator<false> HashMap<K, V>::end() {
+        return Iterator<false>(ctrl + capacity, slots + capacity, slots + capacity);
+}
+
+template <Key K, typename V>
+HashMap<K, V>::Iterator<true> HashMap<K, V>::begin() const {
+        return Iterator<true>(ctrl, slots, slots + capacity);
+}
+
+template <Key K, typename V>
+HashMap<K, V>::Iterator<true> HashMap<K, V>::end() const {
+        return Iterator<true>(ctrl + capacity, slots + capacity, slots + capacity);
+}
+
 #endif
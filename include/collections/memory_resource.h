@@ -0,0 +1,81 @@
+#ifndef VORTEX_MEMORY_RESOURCE_H
+#define VORTEX_MEMORY_RESOURCE_H
+
+#include <cstddef>
+
+/// The source of memory for the collections. By default the collections
+/// allocate on the heap, but each of them can be given a resource on
+/// construction - such as an `Arena`, whose memory is released at once, or a
+/// `PoolResource` - and then allocates all of its storage from it.
+///
+/// The resource is passed by reference and must outlive the collections, which
+/// use it. A moved collection keeps the resource of its origin, while a copy
+/// constructed collection allocates on the heap, since it may outlive the
+/// original.
+class MemoryResource {
+       public:
+        virtual void *allocate(size_t, size_t) = 0;
+        /// Releases the memory, which was allocated with the same size and
+        /// alignment.
+        virtual void deallocate(void *, size_t, size_t) = 0;
+        virtual ~MemoryResource() = default;
+
+        /// Allocates from the resource, or on the heap if it is `nullptr`. The
+        /// collections keep `nullptr` for the heap, so constructing one does not
+        /// need to look up a default resource.
+        static void *allocate(MemoryResource *, size_t, size_t);
+        static void deallocate(MemoryResource *, void *, size_t, size_t);
+};
+
+/// Serves the small allocations from free lists of fixed-size blocks, carved
+/// out of large chunks. Freed blocks are reused by the next allocations of
+/// their size class, so collections, which repeatedly grow and get destroyed,
+/// stop reaching the heap after a warm-up. The larger allocations are passed
+/// to the upstream resource.
+///
+/// A pool is not synchronized - it can either be owned by a single thread, or
+/// be the pool of the current thread, returned by `getThreadLocal`.
+class PoolResource : public MemoryResource {
+       private:
+        static constexpr size_t MIN_BLOCK = 16;
+        static constexpr size_t MAX_BLOCK = 1024;
+        /// The size classes are the powers of two between the two limits.
+        static constexpr size_t SIZE_CLASSES = 7;
+        static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+        struct FreeBlock {
+                FreeBlock *next;
+        };
+
+        struct Chunk {
+                Chunk *next;
+        };
+
+        MemoryResource *upstream;
+        FreeBlock *freeLists[SIZE_CLASSES] = {};
+        Chunk *chunks = nullptr;
+        /// The part of the newest chunk, which is not carved into blocks yet.
+        char *cursor = nullptr;
+        char *limit = nullptr;
+
+        static size_t sizeClass(size_t);
+        char *carve(size_t);
+
+       public:
+        /// Builds a pool, which takes its chunks from the given resource, or
+        /// from the heap if it is `nullptr`.
+        PoolResource(MemoryResource * = nullptr);
+        PoolResource(const PoolResource &) = delete;
+        ~PoolResource();
+
+        PoolResource &operator=(const PoolResource &) = delete;
+
+        void *allocate(size_t, size_t) override;
+        void deallocate(void *, size_t, size_t) override;
+
+        /// The pool of the current thread, destroyed when the thread exits. The
+        /// memory allocated from it must not be used by other threads.
+        static PoolResource &getThreadLocal();
+};
+
+#endif
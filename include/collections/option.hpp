@@ -1,7 +1,11 @@
 #ifndef VORTEX_OPTION_H
 #define VORTEX_OPTION_H
 
+#include <concepts>
+#include <new>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 #include "traits.hpp"
 
@@ -10,38 +14,65 @@
 /// difference that this implementation does not have native support by the C++
 /// language and cannot be pattern-matched.
 ///
+/// The value is kept in uninitialized storage and constructed in place only
+/// when it is set, so an empty `Option` neither requires `T` to be default
+/// constructible nor pays for building one. Unwrapping an lvalue `Option`
+/// returns a reference to its value, while unwrapping a temporary one - such as
+/// the result of `Vector::popBack` - moves the value out of it.
+///
 /// Accessing an unset value throws an `std::runtime_error` exception.
 template <typename T>
 class Option {
        private:
-        T value;
+        alignas(T) unsigned char storage[sizeof(T)];
         bool isSet;
 
+        T& get();
+        const T& get() const;
+
+        /// Destroys the value, if it is set, leaving the container empty.
+        void reset();
+
        public:
         /// Builds an empty value - similar to `None`.
         explicit Option();
         /// Wraps the value - similar to `Some()`.
-        explicit Option(T);
+        explicit Option(const T&);
+        explicit Option(T&&);
+        Option(const Option&)
+                requires std::copy_constructible<T>;
+        /// Moving is `noexcept` whenever moving the value is, so the containers
+        /// of options can move them instead of copying.
+        Option(Option&&) noexcept(std::is_nothrow_move_constructible_v<T>);
+        ~Option();
 
-        Option& operator=(const Option<T>&)
-                requires vortex::Cloneable<T>;
+        Option& operator=(const Option&)
+                requires std::copy_constructible<T>;
+        Option& operator=(Option&&) noexcept(std::is_nothrow_move_constructible_v<T>);
 
         bool isNone() const;
         bool isSome() const;
         /// Attempts to access the value inside the container; throws
         /// `std::runtime_error` exception if the value is not set.
-        T unwrap();
+        T& unwrap() &;
         /// Attempts to access the value inside the container; throws
         /// `std::runtime_error` exception if the value is not set.
-        const T unwrap() const;
+        const T& unwrap() const&;
+        /// Attempts to move the value out of the container; throws
+        /// `std::runtime_error` exception if the value is not set.
+        T unwrap() &&;
         /// Attempts to access the value inside the container; throws
         /// `std::runtime_error` exception with the given message if the value
         /// is not set.
-        T expect(const char*);
+        T& expect(const char*) &;
         /// Attempts to access the value inside the container; throws an
         /// `std::runtime_error` exception with the given message if the value
         /// is not set.
-        const T expect(const char*) const;
+        const T& expect(const char*) const&;
+        /// Attempts to move the value out of the container; throws an
+        /// `std::runtime_error` exception with the given message if the value
+        /// is not set.
+        T expect(const char*) &&;
 };
 
 /// Template specialization for the `Option<T>` type, which provides means to
@@ -75,22 +106,82 @@ class Option<T&> {
         const T& expect(const char*) const;
 };
 
+template <typename T>
+T& Option<T>::get() {
+        return *reinterpret_cast<T*>(storage);
+}
+
+template <typename T>
+const T& Option<T>::get() const {
+        return *reinterpret_cast<const T*>(storage);
+}
+
+template <typename T>
+void Option<T>::reset() {
+        if (isSet) {
+                get().~T();
+                isSet = false;
+        }
+}
+
 template <typename T>
 Option<T>::Option() : isSet(false) {
 }
 
 template <typename T>
-Option<T>::Option(T _value) : value(_value), isSet(true) {
+Option<T>::Option(const T& _value) : isSet(true) {
+        new (storage) T(_value);
+}
+
+template <typename T>
+Option<T>::Option(T&& _value) : isSet(true) {
+        new (storage) T(std::move(_value));
+}
+
+template <typename T>
+Option<T>::Option(const Option& other)
+        requires std::copy_constructible<T>
+    : isSet(other.isSet) {
+        if (isSet) {
+                new (storage) T(other.get());
+        }
+}
+
+template <typename T>
+Option<T>::Option(Option&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : isSet(other.isSet) {
+        if (isSet) {
+                new (storage) T(std::move(other.get()));
+        }
+}
+
+template <typename T>
+Option<T>::~Option() {
+        reset();
 }
 
 template <typename T>
 Option<T>& Option<T>::operator=(const Option<T>& other)
-        requires vortex::Cloneable<T>
+        requires std::copy_constructible<T>
 {
-        if (this != other) {
-                this->isSet = other.isSet;
-                if (this->isSet) {
-                        this->value = other.value;
+        if (this != &other) {
+                reset();
+                if (other.isSet) {
+                        new (storage) T(other.get());
+                        isSet = true;
+                }
+        }
+        return *this;
+}
+
+template <typename T>
+Option<T>& Option<T>::operator=(Option<T>&& other) noexcept(
+    std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+                reset();
+                if (other.isSet) {
+                        new (storage) T(std::move(other.get()));
+                        isSet = true;
                 }
         }
         return *this;
@@ -107,35 +198,51 @@ bool Option<T>::isSome() const {
 }
 
 template <typename T>
-T Option<T>::unwrap() {
+T& Option<T>::unwrap() & {
         if (isNone()) {
                 throw std::runtime_error("Unwrapping a None value.");
         }
-        return value;
+        return get();
 }
 
 template <typename T>
-const T Option<T>::unwrap() const {
+const T& Option<T>::unwrap() const& {
         if (isNone()) {
                 throw std::runtime_error("Unwrapping a None value.");
         }
-        return value;
+        return get();
+}
+
+template <typename T>
+T Option<T>::unwrap() && {
+        if (isNone()) {
+                throw std::runtime_error("Unwrapping a None value.");
+        }
+        return std::move(get());
+}
+
+template <typename T>
+T& Option<T>::expect(const char* msg) & {
+        if (isNone()) {
+                throw std::runtime_error(msg);
+        }
+        return get();
 }
 
 template <typename T>
-T Option<T>::expect(const char* msg) {
+const T& Option<T>::expect(const char* msg) const& {
         if (isNone()) {
                 throw std::runtime_error(msg);
         }
-        return value;
+        return get();
 }
 
 template <typename T>
-const T Option<T>::expect(const char* msg) const {
+T Option<T>::expect(const char* msg) && {
         if (isNone()) {
                 throw std::runtime_error(msg);
         }
-        return value;
+        return std::move(get());
 }
 
 template <typename T>
@@ -0,0 +1,273 @@
+#ifndef VORTEX_SMALL_VECTOR_H
+#define VORTEX_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <utility>
+
+#include "option.hpp"
+#include "traits.hpp"
+
+/// A dynamic array, which stores up to `N` elements inside the object itself
+/// and only allocates heap memory once it grows beyond them. Meant for the
+/// short lists, which are created in large numbers - such as the arguments of
+/// each instruction - where a heap allocation per list would dominate the cost.
+///
+/// Since the inline elements live inside the object, moving a small vector
+/// moves them one by one, unlike `Vector`, which only hands over its storage.
+template <typename T, size_t N>
+class SmallVector {
+        static_assert(N > 0, "SmallVector requires inline storage for at least one element");
+
+       private:
+        static constexpr double ALLOCATOR_COEF = 1.5;
+
+        alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+        T *data;
+        size_t len;
+        size_t cap;
+
+        T *inlineData();
+        bool isInline() const;
+
+        void clone(const SmallVector &)
+                requires vortex::Cloneable<T>;
+        void realloc(size_t);
+        void free();
+        void move(SmallVector &&) noexcept;
+
+       public:
+        SmallVector();
+        SmallVector(const SmallVector &)
+                requires vortex::Cloneable<T>;
+        SmallVector(SmallVector &&) noexcept
+                requires vortex::Moveable<T>;
+        ~SmallVector();
+
+        SmallVector &operator=(const SmallVector &)
+                requires vortex::Cloneable<T>;
+        SmallVector &operator=(SmallVector &&) noexcept
+                requires vortex::Moveable<T>;
+
+        size_t length() const;
+        /// Whether the elements have spilled to the heap.
+        bool isSpilled() const;
+        void clear();
+
+        void pushBack(const T &);
+        void pushBack(T &&)
+                requires vortex::Moveable<T>;
+        /// Constructs the element in place at the back of the vector.
+        template <typename... Args>
+        T &emplaceBack(Args &&...);
+        Option<T> popBack();
+
+        Option<const T &> operator[](size_t) const;
+        Option<T &> operator[](size_t);
+
+        T *begin() const;
+        T *end() const;
+};
+
+template <typename T, size_t N>
+T *SmallVector<T, N>::inlineData() {
+        return reinterpret_cast<T *>(inlineStorage);
+}
+
+template <typename T, size_t N>
+bool SmallVector<T, N>::isInline() const {
+        return data == reinterpret_cast<const T *>(inlineStorage);
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::clone(const SmallVector &other)
+        requires vortex::Cloneable<T>
+{
+        data = inlineData();
+        len = 0;
+        cap = N;
+        if (other.len > N) {
+                realloc(other.len);
+        }
+        for (size_t i = 0; i < other.len; ++i) {
+                new (data + i) T(vortex::clone(other.data[i]));
+        }
+        len = other.len;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::realloc(size_t newCapacity) {
+        T *newData = static_cast<T *>(
+            ::operator new(newCapacity * sizeof(T), std::align_val_t(alignof(T))));
+        for (size_t i = 0; i < len; ++i) {
+                new (newData + i) T(std::move(data[i]));
+                data[i].~T();
+        }
+        if (!isInline()) {
+                ::operator delete(data, std::align_val_t(alignof(T)));
+        }
+        data = newData;
+        cap = newCapacity;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::free() {
+        clear();
+        if (!isInline()) {
+                ::operator delete(data, std::align_val_t(alignof(T)));
+        }
+        data = inlineData();
+        cap = N;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::move(SmallVector &&other) noexcept {
+        if (!other.isInline()) {
+                data = other.data;
+                len = other.len;
+                cap = other.cap;
+                other.data = other.inlineData();
+                other.len = 0;
+                other.cap = N;
+                return;
+        }
+
+        data = inlineData();
+        cap = N;
+        for (size_t i = 0; i < other.len; ++i) {
+                new (data + i) T(std::move(other.data[i]));
+        }
+        len = other.len;
+        other.clear();
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector() : data(inlineData()), len(0), cap(N) {
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(const SmallVector &other)
+        requires vortex::Cloneable<T>
+{
+        clone(other);
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::SmallVector(SmallVector &&other) noexcept
+        requires vortex::Moveable<T>
+{
+        move(std::move(other));
+}
+
+template <typename T, size_t N>
+SmallVector<T, N>::~SmallVector() {
+        free();
+}
+
+template <typename T, size_t N>
+SmallVector<T, N> &SmallVector<T, N>::operator=(const SmallVector &other)
+        requires vortex::Cloneable<T>
+{
+        if (this != &other) {
+                free();
+                clone(other);
+        }
+        return *this;
+}
+
+template <typename T, size_t N>
+SmallVector<T, N> &SmallVector<T, N>::operator=(SmallVector &&other) noexcept
+        requires vortex::Moveable<T>
+{
+        if (this != &other) {
+                free();
+                move(std::move(other));
+        }
+        return *this;
+}
+
+template <typename T, size_t N>
+size_t SmallVector<T, N>::length() const {
+        return len;
+}
+
+template <typename T, size_t N>
+bool SmallVector<T, N>::isSpilled() const {
+        return !isInline();
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::clear() {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_t i = 0; i < len; ++i) {
+                        data[i].~T();
+                }
+        }
+        len = 0;
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::pushBack(const T &value) {
+        emplaceBack(value);
+}
+
+template <typename T, size_t N>
+void SmallVector<T, N>::pushBack(T &&value)
+        requires vortex::Moveable<T>
+{
+        emplaceBack(std::move(value));
+}
+
+template <typename T, size_t N>
+template <typename... Args>
+T &SmallVector<T, N>::emplaceBack(Args &&...args) {
+        if (len == cap) {
+                // The arguments may refer to an element of this vector, so
+                // they are consumed before the elements are relocated.
+                T value(std::forward<Args>(args)...);
+                realloc(std::max(static_cast<size_t>(static_cast<double>(cap) * ALLOCATOR_COEF),
+                                 cap + 1));
+                return *new (data + len++) T(std::move(value));
+        }
+        return *new (data + len++) T(std::forward<Args>(args)...);
+}
+
+template <typename T, size_t N>
+Option<T> SmallVector<T, N>::popBack() {
+        if (len == 0) {
+                return Option<T>();
+        }
+        len -= 1;
+        Option<T> result(std::move(data[len]));
+        data[len].~T();
+        return result;
+}
+
+template <typename T, size_t N>
+Option<const T &> SmallVector<T, N>::operator[](size_t idx) const {
+        if (idx >= len) {
+                return Option<const T &>();
+        }
+        return Option<const T &>(data[idx]);
+}
+
+template <typename T, size_t N>
+Option<T &> SmallVector<T, N>::operator[](size_t idx) {
+        if (idx >= len) {
+                return Option<T &>();
+        }
+        return Option<T &>(data[idx]);
+}
+
+template <typename T, size_t N>
+T *SmallVector<T, N>::begin() const {
+        return data;
+}
+
+template <typename T, size_t N>
+T *SmallVector<T, N>::end() const {
+        return data + len;
+}
+
+#endif
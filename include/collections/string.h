@@ -3,21 +3,52 @@
 #define VORTEX_STRING_H
 
 #include <cstddef>
+#include <cstring>
 #include <fstream>
 
+#include "memory_resource.h"
+#include "string_view.h"
 #include "traits.hpp"
 #include "vector.hpp"
 
-/// Implementation of a heap allocated string, providing convenient abstraction
-/// methods for working with strings.
-class String : public vortex::Compare<String>, public vortex::Hash {
+/// Implementation of a string, providing convenient abstraction methods for
+/// working with strings.
+///
+/// Short strings - such as most mnemonics, registers, literals and labels -
+/// are stored inline in the object and only the longer ones are allocated on
+/// the heap. The inline buffer shares its memory with the heap pointer and a
+/// capacity of exactly `INLINE_CAPACITY` denotes the inline mode.
+///
+/// The longer strings are allocated on the heap, or from the `MemoryResource`
+/// passed on construction.
+///
+/// The comparison and the hashing are not virtual, so a string does not carry
+/// the virtual table pointers of `vortex::Compare` and `vortex::Hash` - it
+/// takes 48 bytes on 64-bit targets.
+class String {
        private:
         static constexpr double ALLOCATOR_COEF = 1.5;
-        static constexpr size_t DEFAULT_CAPACITY = 16;
+        /// The longest string stored inline, excluding the null terminator.
+        static constexpr size_t INLINE_CAPACITY = sizeof(char *) * 2 - 1;
 
-        char *str;
+        union {
+                char *heap;
+                char local[INLINE_CAPACITY + 1];
+        };
         size_t len;
         size_t cap;
+        /// The hash of the characters, computed on the first call to `hash`
+        /// and reset by every modification. Zero means it is not computed.
+        mutable size_t cachedHash = 0;
+        /// The source of the heap buffer, or `nullptr` for the heap.
+        MemoryResource *resource = nullptr;
+
+        bool isInline() const;
+        char *buffer();
+        const char *buffer() const;
+        /// Allocates a buffer for the given capacity and the null terminator.
+        char *allocate(size_t);
+        void deallocate(char *, size_t);
 
         void realloc(size_t);
         void free();
@@ -27,13 +58,21 @@ class String : public vortex::Compare<String>, public vortex::Hash {
         static String between(const char *, const char *);
 
        public:
-        /// Builds an empty string with the `DEFAULT_CAPACITY`.
+        /// Builds an empty string, which does not allocate until it outgrows
+        /// the inline buffer.
         String();
         /// Builds an empty string with a given capacity.
         String(size_t);
-        /// Builds a heap allocated version of the passed string with just
-        /// enough capacity to hold the data.
+        /// Builds an empty string, which allocates from the given resource.
+        explicit String(MemoryResource &);
+        /// Builds a copy of the passed string, allocated from the given
+        /// resource.
+        String(const char *, MemoryResource &);
+        /// Builds a copy of the passed string with just enough capacity to
+        /// hold the data.
         String(const char *);
+        /// Builds a copy of the viewed characters.
+        explicit String(StringView);
         String(const String &);
         String(String &&) noexcept;
         ~String();
@@ -55,6 +94,8 @@ class String : public vortex::Compare<String>, public vortex::Hash {
         size_t length() const;
         /// A C-like view of the underlying string data.
         const char *cStr() const;
+        /// A view of the characters, valid until the string is modified.
+        operator StringView() const;
 
         void append(char);
         void append(const char *);
@@ -67,6 +108,11 @@ class String : public vortex::Compare<String>, public vortex::Hash {
         /// Splits the string into a list of non-empty strings, based on the
         /// passed delimiter.
         Vector<String> split(char) const;
+        /// Splits the string into non-empty strings, based on the passed
+        /// delimiter, and appends them to the given list - allowing the caller
+        /// to choose the container.
+        template <typename List>
+        void splitInto(char, List &) const;
         /// Returns a copy of the substring between the two indices.
         String substr(size_t, size_t) const;
 
@@ -76,13 +122,52 @@ class String : public vortex::Compare<String>, public vortex::Hash {
         /// Removes all characters after the given stop symbol.
         void truncateAfter(char);
 
-        virtual vortex::Ordering compare(const String &) const override;
+        vortex::Ordering compare(const String &) const;
         friend bool operator<(const String &, const String &);
         friend bool operator>(const String &, const String &);
         friend bool operator==(const String &, const String &);
-        virtual size_t hash() const override;
+        size_t hash() const;
 };
 
+template <typename List>
+void String::splitInto(char delimiter, List &result) const {
+        const char *start = buffer();
+        const char *end = strchr(start, delimiter);
+        while (end != nullptr) {
+                if (start != end) {
+                        result.pushBack(between(start, end));
+                }
+                start = end + 1;
+                end = strchr(start, delimiter);
+        }
+        if (*start != '\0') {
+                result.pushBack(between(start, buffer() + len));
+        }
+}
+
+/// The inline characters are addressed relative to the object and the heap
+/// allocated ones do not refer back to it, so the bytes can be moved freely.
+template <>
+struct vortex::IsTriviallyRelocatable<String> : std::true_type {};
+
+/// Strings can be looked up by a view or a C string of their characters.
+template <>
+struct vortex::KeyLookup<String, StringView> {
+        static size_t hash(StringView query) {
+                return query.hash();
+        }
+
+        static bool equals(const String &key, StringView query) {
+                return StringView(key) == query;
+        }
+};
+
+template <>
+struct vortex::KeyLookup<String, const char *> : vortex::KeyLookup<String, StringView> {};
+
+template <size_t N>
+struct vortex::KeyLookup<String, char[N]> : vortex::KeyLookup<String, StringView> {};
+
 String operator+(const char *, const String &);
 std::ostream &operator<<(std::ostream &, const String &);
 
@@ -90,6 +175,7 @@ bool isAlpha(char);
 bool isNumeric(char);
 bool isAlphanumeric(char);
 bool isIdentifier(char);
+bool isWhitespace(char);
 
 size_t atou(const char *);
 int64_t atoi64(const char *);
@@ -0,0 +1,49 @@
+#ifndef VORTEX_STRING_VIEW_H
+#define VORTEX_STRING_VIEW_H
+
+#include <cstddef>
+#include <cstring>
+
+#include "hash.h"
+
+/// A non-owning view of a sequence of characters, which is not necessarily
+/// null terminated. Used for passing around names - such as C string literals
+/// or slices of the source - without copying them into a `String`.
+///
+/// The viewed characters must outlive the view.
+class StringView {
+       private:
+        const char *str;
+        size_t len;
+
+       public:
+        StringView(const char *_str) : str(_str), len(strlen(_str)) {
+        }
+
+        StringView(const char *_str, size_t _len) : str(_str), len(_len) {
+        }
+
+        const char *data() const {
+                return str;
+        }
+
+        size_t length() const {
+                return len;
+        }
+
+        bool isEmpty() const {
+                return len == 0;
+        }
+
+        bool operator==(const StringView &other) const {
+                return len == other.len && 0 == memcmp(str, other.str, len);
+        }
+
+        /// Hashes the characters the same way as `String::hash`, so a view can
+        /// look up an equal `String` key.
+        size_t hash() const {
+                return vortex::hashBytes(str, len);
+        }
+};
+
+#endif
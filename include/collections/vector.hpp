@@ -3,37 +3,31 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
 
+#include "memory_resource.h"
 #include "option.hpp"
 #include "traits.hpp"
 
-/// An utility, which forces the usage of the `operator=` implementation for the
-/// corresponding type `T`.
-template <vortex::Cloneable T>
-static void memclone(T *dst, const T *src, size_t len) {
-        if (nullptr == dst || nullptr == src || len == 0) {
-                return;
-        }
-        for (size_t i = 0; i < len; ++i) {
-                dst[i] = vortex::clone(src[i]);
-        }
-}
-
-/// An utility, which forces the usage of the move version of the `operator=`
-/// implementation for the corresponding type `T`.
-template <vortex::Moveable T>
-static void memmove(T *dst, const T *src, size_t len) {
-        if (nullptr == dst || nullptr == src || len == 0) {
-                return;
-        }
-        for (size_t i = 0; i < len; ++i) {
-                dst[i] = std::move(src[i]);
-        }
-}
-
 /// Implementation of a dynamic array with automatic resizing and memory
 /// management.
 ///
+/// The elements are kept in uninitialized storage - only the slots in use hold
+/// constructed objects, so reserving capacity does not default-construct
+/// anything. Growing the vector move-constructs the elements into the new
+/// storage, or copies their bytes if the type is trivially relocatable.
+///
+/// Removing the first element is O(1) - the vector keeps an offset to its
+/// first element. Once the space in front of the elements is larger than the
+/// elements themselves, appending to a full vector slides them back to the
+/// beginning of the storage instead of growing it, so a vector used as a FIFO
+/// queue keeps a bounded capacity.
+///
+/// The storage is allocated on the heap, or from the `MemoryResource` passed
+/// on construction.
+///
 /// The current implementation uses a trivial cloning mechanism, which should
 /// not be used for storing pointers to an abstract base class. In such case the
 /// implementation of copy constructor and `operator=` will just trigger copying
@@ -50,7 +44,7 @@ class Vector {
                 Iterator(T *);
 
                 bool operator==(const Iterator &) const;
-                T operator*() const;
+                T &operator*() const;
                 Iterator &operator++();
         };
 
@@ -58,9 +52,23 @@ class Vector {
         static constexpr double ALLOCATOR_COEF = 1.5;
         static constexpr size_t DEFAULT_CAPACITY = 16;
 
+        /// The beginning of the allocated storage.
+        T *storage;
+        /// The first element, which is past the beginning of the storage after
+        /// removing elements from the front.
         T *data;
         size_t len;
         size_t cap;
+        /// The source of the storage, or `nullptr` for the heap.
+        MemoryResource *resource = nullptr;
+
+        T *allocate(size_t);
+        void deallocate(T *, size_t);
+        /// Moves the elements to the given uninitialized memory, leaving the
+        /// source memory uninitialized. The ranges may only overlap if the
+        /// destination comes first.
+        static void relocate(T *, T *, size_t);
+        static void destroy(T *, size_t);
 
         void clone(const Vector &)
                 requires vortex::Cloneable<T>;
@@ -68,9 +76,14 @@ class Vector {
         void free();
         void move(Vector &&) noexcept;
 
+        size_t frontOffset() const;
+        size_t nextCapacity() const;
+
        public:
         Vector();
         Vector(size_t);
+        Vector(MemoryResource &);
+        Vector(size_t, MemoryResource &);
         Vector(const Vector &)
                 requires vortex::Cloneable<T>;
         Vector(Vector &&) noexcept
@@ -83,20 +96,38 @@ class Vector {
                 requires vortex::Moveable<T>;
 
         size_t length() const;
-
-        void pushBack(T &);
+        /// Removes all elements, while keeping the allocated capacity for
+        /// reuse.
+        void clear();
+        /// Ensures that the vector can hold the given number of elements
+        /// without reallocating.
+        void reserve(size_t);
+
+        void pushBack(const T &);
         void pushBack(T &&)
                 requires vortex::Moveable<T>;
+        /// Constructs the element in place at the back of the vector.
+        template <typename... Args>
+        T &emplaceBack(Args &&...);
+        /// Moves the last element out of the vector.
         Option<T> popBack();
+        /// Moves the first element out of the vector.
         Option<T> popFront();
 
         Option<const T &> operator[](size_t) const;
         Option<T &> operator[](size_t);
+        /// The element at the index, without the bounds check of
+        /// `operator[]`. The index must already be known to be in bounds.
+        const T &getUnchecked(size_t) const;
+        T &getUnchecked(size_t);
 
         Iterator begin() const;
         Iterator end() const;
 };
 
+template <typename T>
+struct vortex::IsTriviallyRelocatable<Vector<T>> : std::true_type {};
+
 template <typename T>
 Vector<T>::Iterator::Iterator(T *_ptr) : ptr(_ptr) {
 }
@@ -107,7 +138,7 @@ bool Vector<T>::Iterator::operator==(const Iterator &other) const {
 }
 
 template <typename T>
-T Vector<T>::Iterator::operator*() const {
+T &Vector<T>::Iterator::operator*() const {
         return *ptr;
 }
 
@@ -117,32 +148,87 @@ Vector<T>::Iterator &Vector<T>::Iterator::operator++() {
         return *this;
 }
 
+template <typename T>
+T *Vector<T>::allocate(size_t capacity) {
+        if (capacity == 0) {
+                return nullptr;
+        }
+        return static_cast<T *>(
+            MemoryResource::allocate(resource, capacity * sizeof(T), alignof(T)));
+}
+
+template <typename T>
+void Vector<T>::deallocate(T *ptr, size_t capacity) {
+        if (nullptr != ptr) {
+                MemoryResource::deallocate(resource, ptr, capacity * sizeof(T), alignof(T));
+        }
+}
+
+template <typename T>
+void Vector<T>::relocate(T *dst, T *src, size_t count) {
+        if (count == 0 || dst == src) {
+                return;
+        }
+        if constexpr (vortex::TriviallyRelocatable<T>) {
+                std::memmove(static_cast<void *>(dst), static_cast<const void *>(src),
+                             count * sizeof(T));
+        } else {
+                for (size_t i = 0; i < count; ++i) {
+                        new (dst + i) T(std::move(src[i]));
+                        src[i].~T();
+                }
+        }
+}
+
+template <typename T>
+void Vector<T>::destroy(T *ptr, size_t count) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_t i = 0; i < count; ++i) {
+                        ptr[i].~T();
+                }
+        }
+}
+
 template <typename T>
 void Vector<T>::clone(const Vector<T> &other)
         requires vortex::Cloneable<T>
 {
-        this->cap = other.cap;
+        this->cap = other.len;
         this->len = other.len;
-        this->data = new T[this->cap];
-        memclone(this->data, other.data, this->len);
+        this->storage = allocate(this->cap);
+        this->data = this->storage;
+        if constexpr (std::is_trivially_copyable_v<T>) {
+                if (this->len > 0) {
+                        std::memcpy(static_cast<void *>(this->data),
+                                    static_cast<const void *>(other.data), this->len * sizeof(T));
+                }
+        } else {
+                for (size_t i = 0; i < this->len; ++i) {
+                        new (this->data + i) T(vortex::clone(other.data[i]));
+                }
+        }
 }
 
 template <typename T>
 void Vector<T>::realloc(size_t newCapacity) {
-        cap = newCapacity;
-        len = std::min(len, cap);
-
-        T *newData = new T[cap];
-        for (size_t i = 0; i < len; ++i) {
-                newData[i] = std::move(data[i]);
+        if (len > newCapacity) {
+                destroy(data + newCapacity, len - newCapacity);
+                len = newCapacity;
         }
-        delete[] data;
-        data = newData;
+
+        T *newStorage = allocate(newCapacity);
+        relocate(newStorage, data, len);
+        deallocate(storage, cap);
+        storage = newStorage;
+        data = newStorage;
+        cap = newCapacity;
 }
 
 template <typename T>
 void Vector<T>::free() {
-        delete[] data;
+        destroy(data, len);
+        deallocate(storage, cap);
+        storage = nullptr;
         data = nullptr;
         len = 0;
         cap = 0;
@@ -150,22 +236,51 @@ void Vector<T>::free() {
 
 template <typename T>
 void Vector<T>::move(Vector<T> &&other) noexcept {
+        this->storage = other.storage;
         this->data = other.data;
         this->len = other.len;
         this->cap = other.cap;
+        this->resource = other.resource;
+        other.storage = nullptr;
         other.data = nullptr;
         other.len = 0;
         other.cap = 0;
 }
 
 template <typename T>
-Vector<T>::Vector() : len(0), cap(DEFAULT_CAPACITY) {
-        this->data = new T[this->cap];
+size_t Vector<T>::frontOffset() const {
+        return static_cast<size_t>(data - storage);
+}
+
+template <typename T>
+size_t Vector<T>::nextCapacity() const {
+        if (cap == 0) {
+                return DEFAULT_CAPACITY;
+        }
+        const size_t grown = static_cast<size_t>(static_cast<double>(cap) * ALLOCATOR_COEF);
+        return std::max(grown, cap + 1);
+}
+
+template <typename T>
+Vector<T>::Vector() : storage(nullptr), data(nullptr), len(0), cap(0) {
 }
 
 template <typename T>
 Vector<T>::Vector(size_t capacity) : len(0), cap(capacity) {
-        this->data = new T[this->cap];
+        this->storage = allocate(this->cap);
+        this->data = this->storage;
+}
+
+template <typename T>
+Vector<T>::Vector(MemoryResource &_resource)
+    : storage(nullptr), data(nullptr), len(0), cap(0), resource(&_resource) {
+}
+
+template <typename T>
+Vector<T>::Vector(size_t capacity, MemoryResource &_resource)
+    : len(0), cap(capacity), resource(&_resource) {
+        this->storage = allocate(this->cap);
+        this->data = this->storage;
 }
 
 template <typename T>
@@ -215,23 +330,61 @@ size_t Vector<T>::length() const {
 }
 
 template <typename T>
-void Vector<T>::pushBack(T &value) {
-        if (len == cap) {
-                cap = static_cast<size_t>(static_cast<double>(cap) * ALLOCATOR_COEF);
-                realloc(cap);
+void Vector<T>::clear() {
+        destroy(data, len);
+        data = storage;
+        len = 0;
+}
+
+template <typename T>
+void Vector<T>::reserve(size_t capacity) {
+        if (capacity > cap - frontOffset()) {
+                realloc(std::max(capacity, len));
         }
-        data[len++] = value;
+}
+
+template <typename T>
+void Vector<T>::pushBack(const T &value) {
+        emplaceBack(value);
 }
 
 template <typename T>
 void Vector<T>::pushBack(T &&value)
         requires vortex::Moveable<T>
 {
-        if (len == cap) {
-                cap = static_cast<size_t>(static_cast<double>(cap) * ALLOCATOR_COEF);
-                realloc(cap);
+        emplaceBack(std::move(value));
+}
+
+template <typename T>
+template <typename... Args>
+T &Vector<T>::emplaceBack(Args &&...args) {
+        if (frontOffset() + len < cap) {
+                T *slot = new (data + len) T(std::forward<Args>(args)...);
+                len += 1;
+                return *slot;
+        }
+
+        // The elements are slid back to the beginning of the storage, when the
+        // space in front of them is larger than they are, and moved to a
+        // larger storage otherwise. The arguments may refer to an element of
+        // this vector, so the new element is constructed first - in both cases
+        // its slot does not overlap with the current elements.
+        T *newStorage = storage;
+        const bool grow = frontOffset() <= len;
+        const size_t newCapacity = grow ? nextCapacity() : cap;
+        if (grow) {
+                newStorage = allocate(newCapacity);
         }
-        data[len++] = std::move(value);
+        T *slot = new (newStorage + len) T(std::forward<Args>(args)...);
+        relocate(newStorage, data, len);
+        if (grow) {
+                deallocate(storage, cap);
+                storage = newStorage;
+                cap = newCapacity;
+        }
+        data = newStorage;
+        len += 1;
+        return *slot;
 }
 
 template <typename T>
@@ -239,8 +392,10 @@ Option<T> Vector<T>::popBack() {
         if (len == 0) {
                 return Option<T>();
         }
-        T value = data[--len];
-        return Option<T>(value);
+        len -= 1;
+        Option<T> result(std::move(data[len]));
+        data[len].~T();
+        return result;
 }
 
 template <typename T>
@@ -248,12 +403,11 @@ Option<T> Vector<T>::popFront() {
         if (len == 0) {
                 return Option<T>();
         }
-        T result = data[0];
-        for (size_t i = 0; i < len - 1; ++i) {
-                data[i] = data[i + 1];
-        }
+        Option<T> result(std::move(data[0]));
+        data[0].~T();
         len -= 1;
-        return Option<T>(result);
+        data = len == 0 ? storage : data + 1;
+        return result;
 }
 
 template <typename T>
@@ -272,6 +426,16 @@ Option<T &> Vector<T>::operator[](size_t idx) {
         return Option<T &>(data[idx]);
 }
 
+template <typename T>
+const T &Vector<T>::getUnchecked(size_t idx) const {
+        return data[idx];
+}
+
+template <typename T>
+T &Vector<T>::getUnchecked(size_t idx) {
+        return data[idx];
+}
+
 template <typename T>
 Vector<T>::Iterator Vector<T>::begin() const {
         return Iterator(data);
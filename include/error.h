@@ -5,23 +5,24 @@
 #include <exception>
 
 #include "collections/string.h"
+#include "collections/string_view.h"
 
 /// Provides information about the context, in which an error has risen. This
 /// way the user can more easily identify the wrong line of the source code,
 /// which caused the failure.
+///
+/// The context only views the name of the source, which is owned by the
+/// parser or the program, so it is cheap to copy and to pass to exceptions.
 struct Context {
        public:
+        StringView filename = "";
         size_t ln = 0;
-        String filename;
-
-       private:
-        void clone(const Context &);
+        /// The column, at which the code on the line starts, or 0 if unknown.
+        size_t column = 0;
 
        public:
         Context() = default;
-        Context(const String &);
-        Context(const Context &);
-        Context &operator=(const Context &);
+        Context(StringView);
 
         /// Returns a formatted message, that is designed to be used as a prefix
         /// to the different exceptions, which shows the file name and the line,
@@ -105,6 +106,13 @@ class UnknownInstructionException : public VortexException {
         UnknownInstructionException(const Context &, const String &);
 };
 
+/// Thrown when an `ncall` instruction refers to a host function, which is not
+/// registered.
+class UnknownHostFunctionException : public VortexException {
+       public:
+        UnknownHostFunctionException(const Context &, const String &);
+};
+
 /// When the `main` label is missing from the executable script.
 class MissingEntryPointException : public VortexException {
        public:
@@ -0,0 +1,91 @@
+#ifndef VORTEX_HOST_FUNCTION_H
+#define VORTEX_HOST_FUNCTION_H
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "collections/option.hpp"
+#include "collections/string.h"
+#include "collections/vector.hpp"
+#include "symbol_table.h"
+
+class Vm;
+
+/// A native function, which the scripts call via the `ncall` instruction. The
+/// arguments are read from the registers, starting from `r0`, and the returned
+/// value is written back to `r0`.
+///
+/// The function is either raw - taking the whole `Vm` - or typed, in which case
+/// its parameters are filled from the registers. Both are stored as a plain
+/// function pointer along with a trampoline, which restores its type, so a
+/// call costs no more than two indirect calls.
+class HostFunction {
+       public:
+        using Raw = double (*)(Vm &);
+
+       private:
+        using Erased = void (*)();
+        using Trampoline = double (*)(Erased, Vm &, const double *);
+
+        static constexpr size_t MAX_ARGUMENTS = 16;
+
+        Erased function = nullptr;
+        Trampoline trampoline = nullptr;
+
+        static double invokeRaw(Erased, Vm &, const double *);
+
+        template <typename... Args, size_t... Idx>
+        static double invokeTyped(Erased fn, const double *registers,
+                                  std::index_sequence<Idx...>) {
+                return reinterpret_cast<double (*)(Args...)>(fn)(static_cast<Args>(registers[Idx])...);
+        }
+
+        template <typename... Args>
+        static double invokeTyped(Erased fn, Vm &, const double *registers) {
+                return invokeTyped<Args...>(fn, registers, std::index_sequence_for<Args...>());
+        }
+
+       public:
+        HostFunction() = default;
+        HostFunction(Raw);
+
+        template <typename... Args>
+        HostFunction(double (*fn)(Args...))
+            : function(reinterpret_cast<Erased>(fn)), trampoline(invokeTyped<Args...>) {
+                static_assert(sizeof...(Args) <= MAX_ARGUMENTS,
+                              "Host functions take at most one argument per register");
+        }
+
+        /// Accepts the lambdas without captures, which convert to one of the
+        /// function pointers above.
+        template <typename Lambda>
+                requires std::is_empty_v<Lambda>
+        HostFunction(Lambda fn) : HostFunction(+fn) {
+        }
+
+        double operator()(Vm &) const;
+};
+
+/// A registry of the host functions, visible to the scripts by their names.
+/// The names are resolved once, while linking the `ncall` instructions, so the
+/// registry is not consulted during the execution.
+class HostFunctions {
+       private:
+        SymbolTable names;
+        /// The functions, indexed by the symbols of their names.
+        Vector<HostFunction> functions;
+
+        static HostFunctions GLOBAL_HOST_FUNCTIONS;
+
+       public:
+        /// Registers the function under the given name. Throws
+        /// `std::invalid_argument` if the name is already taken.
+        void define(StringView, HostFunction);
+        Option<HostFunction> find(StringView) const;
+
+        /// The registry used by default by every `Parser`.
+        static HostFunctions &getGlobal();
+};
+
+#endif
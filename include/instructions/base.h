@@ -1,6 +1,11 @@
 #ifndef VORTEX_INSTRUCTIONS_BASE_H
 #define VORTEX_INSTRUCTIONS_BASE_H
 
+#include <cstddef>
+#include <stdexcept>
+
+#include "arena.h"
+
 class Vm;
 class AsmReader;
 
@@ -8,9 +13,17 @@ class AsmReader;
 /// different supported instructions in the language. The process of creating
 /// the separate instances of the instructions classes can be viewed in greater
 /// detail inside the `parser.h` header.
-class Instruction {
+///
+/// The instructions of a compiled `Program` are placed in its arena.
+class Instruction : public ArenaAllocated {
        public:
         virtual void execute(Vm &) const = 0;
+        /// Sets the location of the label referenced by the instruction, which
+        /// was not yet declared when the instruction was created. Only
+        /// implemented by the instructions, which reference labels.
+        virtual void patchLabelLocation(size_t) {
+                throw std::logic_error("Patching an instruction, which does not reference a label");
+        }
         virtual ~Instruction() = default;
 };
 
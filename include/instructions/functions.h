@@ -5,28 +5,44 @@
 
 #include "base.h"
 #include "collections/box.hpp"
+#include "host_function.h"
 
 /// Jumps to the given location inside the source code.
 class Jmp : public Instruction {
        private:
-        const size_t location;
+        size_t location;
 
        public:
         Jmp(size_t);
         static Box<Instruction> factory(AsmReader);
         void execute(Vm &) const override;
+        void patchLabelLocation(size_t) override;
 };
 
 /// Jumps to the location inside the source code, whilst pushing the current
 /// instruction pointer on the stack, simplifying the return process.
 class Call : public Instruction {
        private:
-        const size_t location;
+        size_t location;
 
        public:
         Call(size_t);
         static Box<Instruction> factory(AsmReader);
         void execute(Vm &) const override;
+        void patchLabelLocation(size_t) override;
+};
+
+/// Calls a native host function, which was resolved while linking. The
+/// arguments are taken from the registers, starting from `r0`, and the result
+/// is stored in `r0`.
+class NativeCall : public Instruction {
+       private:
+        const HostFunction function;
+
+       public:
+        NativeCall(const HostFunction &);
+        static Box<Instruction> factory(AsmReader);
+        void execute(Vm &) const override;
 };
 
 /// Pops the last value of the stack and jumps to that location. If no value is
@@ -9,4 +9,16 @@
 #include "operations.h"
 #include "stack.h"
 
+/// Groups the instructions by their effect on the control flow of the program.
+/// Used by the instrumentation of the VM, which needs to follow the calls and
+/// the branches without knowing the concrete instruction types.
+enum class InstructionKind {
+        Call,
+        Return,
+        Branch,
+        Other,
+};
+
+InstructionKind classifyInstruction(const Instruction &);
+
 #endif
@@ -40,6 +40,61 @@ class FloatingBinOpr : public BinOpr {
         static Box<Instruction> subf(AsmReader);
         static Box<Instruction> mulf(AsmReader);
         static Box<Instruction> divf(AsmReader);
+
+        static Box<Instruction> pow(AsmReader);
+        static Box<Instruction> min(AsmReader);
+        static Box<Instruction> max(AsmReader);
+        void execute(Vm &vm) const override;
+};
+
+/// Represents the math functions of a single floating point argument, backed
+/// by the C math library. Uses the following syntax:
+/// ```
+/// <instruction> <register> <value>
+/// ```
+/// which means that:
+/// ```
+/// <register> = <function>(<value>)
+/// ```
+class FloatingUnOpr : public Instruction {
+       private:
+        const Register dst;
+        const Box<Value> src;
+        double (*const operation)(double);
+
+        static Box<Instruction> factory(AsmReader, double (*const)(double));
+
+       public:
+        FloatingUnOpr(const Register &, Box<Value> &&, double (*const)(double));
+
+        static Box<Instruction> sqrt(AsmReader);
+        static Box<Instruction> sin(AsmReader);
+        static Box<Instruction> cos(AsmReader);
+        static Box<Instruction> exp(AsmReader);
+        static Box<Instruction> log(AsmReader);
+        static Box<Instruction> abs(AsmReader);
+        static Box<Instruction> floor(AsmReader);
+        void execute(Vm &vm) const override;
+};
+
+/// Multiplies two values and adds the product to the destination register with
+/// a single rounding:
+/// ```
+/// fma <register> <value> <value>
+/// ```
+/// which means that:
+/// ```
+/// <register> = <value> * <value> + <register>
+/// ```
+class FusedMultiplyAdd : public Instruction {
+       private:
+        const Register dst;
+        const Box<Value> lhs;
+        const Box<Value> rhs;
+
+       public:
+        FusedMultiplyAdd(const Register &, Box<Value> &&, Box<Value> &&);
+        static Box<Instruction> factory(AsmReader);
         void execute(Vm &vm) const override;
 };
 
@@ -0,0 +1,46 @@
+#ifndef VORTEX_LABEL_TABLE_H
+#define VORTEX_LABEL_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "collections/option.hpp"
+#include "collections/string_view.h"
+#include "collections/vector.hpp"
+#include "symbol_table.h"
+
+/// Maps the labels of a program to their instruction locations. The label
+/// names are interned, so the labels are identified by their `Symbol` and the
+/// locations are stored in an array indexed by it - once a reference is
+/// interned, resolving it takes no hashing or string comparisons.
+class LabelTable {
+       public:
+        static constexpr size_t NO_LOCATION = SIZE_MAX;
+
+       private:
+        SymbolTable symbols;
+        /// The location of each symbol, or `NO_LOCATION` for the symbols,
+        /// which are only referenced.
+        Vector<size_t> locations;
+        /// The labels declared by the user, in order of declaration.
+        Vector<Symbol> declared;
+
+       public:
+        /// Returns the symbol of the label, without defining it.
+        Symbol intern(StringView);
+        /// Declares a label written by the user at the given location. Returns
+        /// false if the label is already defined.
+        bool declare(Symbol, size_t);
+        /// Sets the location of a label, generated by the parser.
+        void define(Symbol, size_t);
+        /// Moves every user declared label to a new location, based on the
+        /// mapping from the old locations to the new ones.
+        void relocate(const Vector<size_t> &);
+
+        Option<size_t> locate(Symbol) const;
+        Option<size_t> find(StringView) const;
+        const char *name(Symbol) const;
+        const Vector<Symbol> &getDeclared() const;
+};
+
+#endif
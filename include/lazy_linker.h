@@ -0,0 +1,82 @@
+#ifndef VORTEX_LAZY_LINKER_H
+#define VORTEX_LAZY_LINKER_H
+
+#include <cstddef>
+
+#include "arena.h"
+#include "collections/box.hpp"
+#include "collections/vector.hpp"
+#include "host_function.h"
+#include "instructions/base.h"
+#include "parser.h"
+
+class Program;
+class LazyLinker;
+
+/// Holds the place of an instruction, which is not linked yet. Executing it
+/// links the whole region of the instruction and leaves the instruction
+/// pointer in place, so the VM goes on with the linked instruction.
+class LinkStub : public Instruction {
+       private:
+        LazyLinker &linker;
+
+       public:
+        LinkStub(LazyLinker &);
+        void execute(Vm &) const override;
+};
+
+/// Parses and links the instructions of a lazily compiled `Program` on demand.
+/// The parser only declares the labels and records the line of each
+/// instruction, while the program starts out with a `LinkStub` in place of
+/// each instruction. The code is split into regions at the label locations and
+/// the first instruction executed inside a region parses and links all of it,
+/// so the cost is only paid for the code, which is actually executed.
+///
+/// Any error inside the instructions of a region, such as an unknown
+/// instruction or label, is only reported once the region is executed.
+class LazyLinker {
+       private:
+        /// Holds the linked instructions and their operands. The program only
+        /// reads its own arena, which holds the placeholders.
+        Arena arena;
+        /// The program, which owns the linker. Updated whenever the program
+        /// is moved.
+        Program *program = nullptr;
+        /// The source code of the program.
+        String source;
+        /// The offset of the line of each instruction inside the source.
+        Vector<size_t> instructionOffsets;
+        /// The index of the first instruction of each region, in ascending
+        /// order.
+        Vector<size_t> regionStarts;
+        Vector<bool> linkedRegions;
+        const InstructionFactory &instructionFactory;
+        const HostFunctions &hostFunctions;
+
+        size_t findRegion(size_t) const;
+        /// The code on the line of the instruction with the given index.
+        String instructionCode(size_t) const;
+        void linkRegion(size_t);
+
+       public:
+        /// Takes over the source and the offsets of its instruction lines,
+        /// which are split into regions, starting at the given label
+        /// locations. The host functions must outlive the program.
+        LazyLinker(String &&, Vector<size_t> &&, const Vector<size_t> &,
+                   const InstructionFactory &, const HostFunctions &);
+        LazyLinker(const LazyLinker &) = delete;
+
+        LazyLinker &operator=(const LazyLinker &) = delete;
+
+        void attach(Program &);
+        /// Builds the placeholder of each instruction, placed in the arena of
+        /// the current scope.
+        Vector<Box<Instruction>> createStubs();
+        /// Links the region, which contains the instruction at the given
+        /// index, unless it is already linked.
+        void link(size_t);
+        /// Links all regions, which are not linked yet.
+        void linkAll();
+};
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef VORTEX_MAPPED_FILE_H
+#define VORTEX_MAPPED_FILE_H
+
+#include <cstddef>
+
+#include "collections/string.h"
+#include "collections/string_view.h"
+
+/// A read-only memory mapping of a whole file. The contents are paged in by
+/// the operating system on access, so large sources can be parsed without
+/// first copying them into memory.
+class MappedFile {
+       private:
+        const char *data = nullptr;
+        size_t size = 0;
+
+       public:
+        /// Throws `std::runtime_error` if the file cannot be opened or mapped.
+        MappedFile(const String &);
+        MappedFile(const MappedFile &) = delete;
+        ~MappedFile();
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        /// The contents of the file, valid for the lifetime of the mapping.
+        StringView contents() const;
+};
+
+#endif
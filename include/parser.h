@@ -1,36 +1,59 @@
 #ifndef VORTEX_PARSER_H
 #define VORTEX_PARSER_H
 
+#include <exception>
 #include <iostream>
 #include <istream>
 
-#include "collections/hash_map.hpp"
+#include "collections/small_vector.hpp"
 #include "collections/string.h"
 #include "error.h"
+#include "host_function.h"
 #include "instructions/instructions.h"
+#include "label_table.h"
+#include "program.h"
+#include "symbol_table.h"
 #include "value.h"
 #include "vm.h"
 
+/// The most arguments taken by any instruction.
+static constexpr size_t MAX_INSTRUCTION_ARGS = 3;
+
+/// The arguments of a single instruction, which never need a heap allocation
+/// of their own.
+using InstructionArgs = SmallVector<String, MAX_INSTRUCTION_ARGS>;
+
 /// An abstraction, used to encapsulate and simplify the parsing of instruction
 /// arguments. The `expect` methods provide convenient abstraction over the data
 /// validation.
 class AsmReader {
        private:
         const Context &ctx;
-        const Vector<String> &args;
-        const HashMap<String, size_t> &labels;
+        const InstructionArgs &args;
+        const LabelTable &labels;
+        const HostFunctions &hostFunctions;
+        /// The label referenced by the instruction, interned while parsing.
+        const Symbol target;
+        /// If set, a reference to a label, which is not declared yet, is
+        /// deferred instead of failing - the label is stored here and the
+        /// instruction gets a placeholder location, to be patched later.
+        Symbol *deferredLabel;
 
         unsigned readPos = 0;
 
         String expectArg();
 
        public:
-        AsmReader(const Context &, const Vector<String> &, const HashMap<String, size_t> &);
+        AsmReader(const Context &, const InstructionArgs &, const LabelTable &,
+                  const HostFunctions &, Symbol = SymbolTable::NO_SYMBOL, Symbol * = nullptr);
 
         Register expectRegister();
         Literal expectLiteral();
         Box<Value> expectValue();
         size_t expectLabelLocation();
+        /// Resolves the name of a registered host function, so the linked
+        /// instruction can call it directly.
+        HostFunction expectHostFunction();
         /// Used to signal that the instruction does not take any more arguments
         /// and that there should not be more passed.
         void expectEndOfArgs();
@@ -40,19 +63,33 @@ class AsmReader {
 /// When going over the instructions, the parser uses this map to check which
 /// method it needs to call in order to create the appropriate `Instruction`
 /// object. If no method is found, then the given instruction is invalid.
+///
+/// The mnemonics are interned, so the parsed instructions refer to them by
+/// their `Symbol`, which directly indexes the factory methods.
 class InstructionFactory {
        public:
         using Method = Box<Instruction> (*)(AsmReader);
-        using Map = HashMap<String, Method>;
 
        private:
-        static Map GLOBAL_INSTRUCTION_FACTORY;
+        SymbolTable mnemonics;
+        /// The factory method of each mnemonic, indexed by its symbol.
+        Vector<Method> methods;
+
+        static InstructionFactory GLOBAL_INSTRUCTION_FACTORY;
+
+        void insert(const char *, Method);
 
        public:
+        Option<Symbol> find(StringView) const;
+        /// Returns the symbol of a mnemonic, which is known to exist.
+        Symbol expect(const char *) const;
+        Method getMethod(Symbol) const;
+        const char *getMnemonic(Symbol) const;
+
         // Flyweight design pattern - there is no need to create separate
         // instances of this global instruction factory for each individual
         // parser instance since the syntax of the language remains the same.
-        static const Map &getGlobalInstructionFactory();
+        static const InstructionFactory &getGlobalInstructionFactory();
 };
 
 /// The component of the language, which takes in the user script and converts
@@ -69,17 +106,138 @@ class Parser {
         /// This approach allows for jumping to future defined labels, which
         /// greatly eases the user in most cases.
         struct RawInstruction {
-                String name;
-                Vector<String> args;
-                Context ctx;
+                Symbol mnemonic;
+                InstructionArgs args;
+                /// The position of the instruction, whose file refers to the
+                /// interned `files` of the parser.
+                SourceLocation location;
+                /// The label referenced by a `jmp` or a `call`, interned while
+                /// parsing.
+                Symbol target = SymbolTable::NO_SYMBOL;
+        };
+
+       private:
+        /// A reference to a label, which was not declared yet when the
+        /// referencing instruction was created in the single pass mode.
+        struct Fixup {
+                size_t instructionIdx;
+                Symbol label;
+                SourceLocation location;
+                /// The next fixup of the same label, or `NO_FIXUP`.
+                size_t next;
+        };
+
+        /// A label declared inside a chunk of the parallel parsing mode.
+        struct LabelDeclaration {
+                Symbol label;
+                size_t instructionIdx;
+                SourceLocation location;
+        };
+
+        /// The result of parsing a single chunk of the source on a worker
+        /// thread. Its labels are not declared - every label reference becomes
+        /// a fixup, which is resolved once the chunks are merged. The symbols
+        /// refer to the chunk's own `labels`.
+        struct ParsedChunk {
+                /// Declared first, so that it outlives the instructions placed
+                /// in it.
+                Arena arena;
+                Vector<Box<Instruction>> instructions;
+                Vector<SourceLocation> locations;
+                LabelTable labels;
+                Vector<LabelDeclaration> declarations;
+                Vector<Fixup> fixups;
+                /// The failure of the worker, rethrown while merging.
+                std::exception_ptr error;
         };
 
        private:
-        HashMap<String, size_t> labels;
-        const InstructionFactory::Map &instructionFactory;
+        /// The maximum number of instructions a label's body may span in order
+        /// for calls to it to be inlined (excluding the final `return`).
+        static constexpr size_t INLINE_BUDGET = 8;
+        static constexpr size_t NO_FIXUP = SIZE_MAX;
+        /// The parallel mode splits the source into more chunks than threads,
+        /// so that a thread finishing early can take over another chunk.
+        static constexpr size_t CHUNKS_PER_THREAD = 4;
+        /// The smallest chunk worth handing to a separate thread.
+        static constexpr size_t MIN_CHUNK_SIZE = 64 * 1024;
 
-        void parseLabel(const String &, const Context &, size_t);
+       private:
+        LabelTable labels;
+        /// The names of the parsed sources, interned so that the locations
+        /// refer to them by index instead of copying them.
+        SymbolTable files;
+        /// The source file, which is being parsed.
+        uint16_t currentFile = 0;
+        /// The location of each linked instruction, kept for diagnostics.
+        Vector<SourceLocation> sourceLocations;
+        const InstructionFactory &instructionFactory;
+        const HostFunctions &hostFunctions;
+        bool inlining = true;
+        bool singlePass = false;
+        bool lazyLinking = false;
+        size_t threads = 1;
+
+        /// The unresolved label references of the single pass mode. The
+        /// fixups of each label are chained, starting from `firstFixup`,
+        /// which is indexed by the label's symbol.
+        Vector<Fixup> fixups;
+        Vector<size_t> firstFixup;
+
+        /// The mnemonics, which affect the control flow and are handled by the
+        /// inliner.
+        const Symbol jmpMnemonic;
+        const Symbol callMnemonic;
+        const Symbol returnMnemonic;
+        /// The mnemonics, which may access the stack beneath the call frame
+        /// and thus prevent inlining. `ncall` hands the whole `Vm` to the raw
+        /// host functions, which may read the stack as well.
+        const Symbol pushMnemonic;
+        const Symbol popMnemonic;
+        const Symbol ncallMnemonic;
+
+        /// Starts parsing a source with the given name, returning the context
+        /// for its diagnostics.
+        Context beginSource(const String &);
+        /// The context of the diagnostics for the given instruction location.
+        Context locationContext(const SourceLocation &) const;
+
+        /// Validates the label declared on the line and returns its name.
+        static String parseLabelName(const String &, const Context &);
+        /// Declares the label at the given location and returns its symbol.
+        Symbol parseLabel(const String &, const Context &, size_t);
+        /// Splits the code of an instruction line into its mnemonic and
+        /// arguments, without resolving its label.
+        static RawInstruction tokenizeInstruction(const String &, const Context &,
+                                                  const InstructionFactory &,
+                                                  const SourceLocation &);
         RawInstruction parseInstruction(const String &, const Context &);
+        /// The location of the line, on which the context is.
+        SourceLocation currentLocation(const Context &) const;
+
+        bool isConditional(Symbol) const;
+        /// Checks whether the instruction at the given index is guarded by a
+        /// preceding `if` statement, meaning that it could be skipped at
+        /// runtime.
+        bool isGuarded(const Vector<RawInstruction> &, size_t) const;
+
+        /// Checks whether the body of the given label can be inlined and if so,
+        /// returns the index of its terminating `return` instruction. A body is
+        /// inlinable when it fits in the `INLINE_BUDGET`, does not call itself,
+        /// does not jump outside of its own bounds and does not touch the
+        /// stack. Inlining drops the call frame, so a `push`, a `pop` or a host
+        /// function called via `ncall` would see different values than in the
+        /// called body.
+        Option<size_t> findInlineBody(const Vector<RawInstruction> &, Symbol) const;
+        /// Copies the body between the two indices in place of a call site. Any
+        /// jumps inside the body are redirected to freshly numbered labels and
+        /// any `return` becomes a jump to the end of the copy.
+        void inlineBody(const Vector<RawInstruction> &, size_t, size_t, size_t,
+                        Vector<RawInstruction> &);
+        /// Replaces the calls to small labels with copies of their bodies,
+        /// saving the call frame push, the jump and the `return` at runtime.
+        /// The `labels` are relocated to match the resulting instructions.
+        Vector<RawInstruction> inlineCalls(const Vector<RawInstruction> &);
 
         /// The first walk of the parsing process, populating the `labels` map
         /// and parsing the file into a sequence of raw instructions.
@@ -87,16 +245,113 @@ class Parser {
         /// The second walk over the program, which turns the raw instructions
         /// into the result `Instruction` objects and dynamically links the
         /// instructions to the labels.
-        Vector<Box<Instruction>> linkInstructions(const Vector<RawInstruction> &);
+        Vector<Box<Instruction>> linkInstructions(const Vector<RawInstruction> &, Context &);
+        /// Turns a single raw instruction into an `Instruction` object. If a
+        /// label symbol is given, a reference to an undeclared label is
+        /// stored there instead of failing.
+        Box<Instruction> linkInstruction(const RawInstruction &, Context &, Symbol * = nullptr);
+
+        /// Parses the source in a single walk, emitting each instruction as
+        /// soon as its line is read. The references to labels, which are
+        /// declared later, are recorded as fixups and patched once the label
+        /// is declared.
+        Vector<Box<Instruction>> parseSinglePass(std::istream &, Context &);
+        void addFixup(size_t, Symbol, const SourceLocation &);
+        void resolveFixups(Symbol, size_t, Vector<Box<Instruction>> &);
+        /// Fails with `UnknownLabelException` for the first reference to a
+        /// label, which was never declared.
+        void checkFixups();
+
+        /// Splits the source at line boundaries into the chunks of the
+        /// parallel mode, returning each chunk with the number of its first
+        /// line.
+        Vector<std::pair<StringView, size_t>> splitIntoChunks(StringView) const;
+        /// Parses a chunk of the source on a worker thread, starting from the
+        /// given line number.
+        void parseChunk(StringView, const String &, size_t, ParsedChunk &);
+        /// Declares the labels of all chunks at their final locations, patches
+        /// the label references and concatenates the instructions.
+        Vector<Box<Instruction>> mergeChunks(Vector<ParsedChunk> &, Arena &);
+
+        /// Declares the labels of the source and records the location of each
+        /// instruction, without parsing the instructions themselves. Returns
+        /// the offset of each instruction line inside the source.
+        Vector<size_t> indexSource(StringView, Context &);
+        /// The locations of the labels inside a program of the given length,
+        /// in ascending order and always starting from 0.
+        Vector<size_t> findRegionStarts(size_t) const;
+        /// Indexes the source without parsing its instructions. The program is
+        /// left with placeholders, which parse and link the code on its first
+        /// execution.
+        Program compileLazy(std::istream &, const String &);
+
+        /// Builds the program out of the parsed instructions, moving the labels
+        /// and the source locations into it and resetting the parser.
+        Program takeProgram(const String &, Arena &&, Vector<Box<Instruction>> &&,
+                            Option<Box<LazyLinker>> &&);
 
        public:
         Parser();
+        /// Creates a parser, which links the `ncall` instructions against the
+        /// given host functions instead of the global ones.
+        Parser(const HostFunctions &);
 
         /// Reads the source file and turns it into a sequence of program
         /// `Instruction` objects.
         Vector<Box<Instruction>> parseFile(const String &filename);
+        /// Reads the source code from the given stream and turns it into a
+        /// sequence of program `Instruction` objects. The name of the source is
+        /// only used for the error messages.
+        Vector<Box<Instruction>> parse(std::istream &, const String &name);
+        /// Parses the source code into a self-contained `Program`, which takes
+        /// over the labels of the parser. The instructions and their operands
+        /// are placed contiguously in an arena owned by the program. Afterwards the parser is reset and
+        /// can be used for compiling another program.
+        Program compile(std::istream &, const String &name);
+        /// Toggles the inlining of small call targets, which is enabled by
+        /// default.
+        void setInlining(bool);
+        /// Parses the source file into a `Program`. With more than one thread,
+        /// the file is memory-mapped and parsed with `compileParallel`,
+        /// otherwise it is read and parsed by `compile`.
+        Program compileFile(const String &filename);
+        /// Parses the source on multiple threads into a `Program`. The source
+        /// is split at line boundaries into chunks, which are parsed
+        /// independently into their own instructions and labels. The chunks
+        /// are then merged - their labels are declared at the offset
+        /// locations and the label references are resolved. Like the single
+        /// pass mode, this mode does not perform inlining.
+        Program compileParallel(StringView, const String &name);
+        /// Sets the number of threads used by `compileFile` and
+        /// `compileParallel`, which is 1 by default.
+        void setThreads(size_t);
+        /// Toggles the single pass mode, which is disabled by default. Instead
+        /// of first reading the whole source into raw instructions, each line
+        /// is linked as soon as it is read, so only the linked instructions
+        /// are kept in memory. Inlining needs the whole source, so it is not
+        /// performed in this mode.
+        void setSinglePass(bool);
+        /// Toggles the lazy linking of the compiled programs, which is
+        /// disabled by default. The parser only indexes the labels and the
+        /// lines of the instructions, while each region between two labels is
+        /// parsed and linked on its first execution, so the startup cost is
+        /// mostly proportional to the executed code. Only the label
+        /// declarations are validated while compiling - the errors inside the
+        /// instructions are reported once their code is executed. Applies to
+        /// `compile`, takes precedence over the single pass mode and does not
+        /// perform inlining.
+        void setLazyLinking(bool);
+        /// Strips the comment and the surrounding whitespace of a source line.
+        static String extractCode(const String &);
         /// Used to find and determine the entrypoint of the program.
-        const HashMap<String, size_t> &getLabels() const;
+        const LabelTable &getLabels() const;
+        /// The location of each instruction, returned by `parseFile`.
+        const Vector<SourceLocation> &getSourceLocations() const;
+        /// The names of the parsed sources, indexed by the `file` of the
+        /// locations.
+        const SymbolTable &getFiles() const;
+
+        friend class LazyLinker;
 };
 
 #endif
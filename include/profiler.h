@@ -0,0 +1,109 @@
+#ifndef VORTEX_PROFILER_H
+#define VORTEX_PROFILER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "collections/box.hpp"
+#include "collections/string.h"
+#include "collections/vector.hpp"
+#include "instructions/instructions.h"
+#include "source_map.h"
+#include "vm.h"
+
+/// Collects the exact number of executions and the accumulated cost of every
+/// instruction of a program, along with the call stacks in which they were
+/// executed. The profiler is an `ExecutionObserver` policy of `Vm::execute`, so
+/// the regular dispatch loop does not pay for it when it is unused.
+///
+/// The costs are measured in CPU timestamp counter cycles where available and
+/// in nanoseconds of the steady clock otherwise.
+class Profiler {
+       public:
+        using Ticks = uint64_t;
+
+       private:
+        static constexpr size_t NO_FRAME = SIZE_MAX;
+        /// The number of entries shown in each table of the summary.
+        static constexpr size_t SUMMARY_ROWS = 20;
+
+        struct Counter {
+                size_t executions = 0;
+                Ticks ticks = 0;
+        };
+
+        /// A node of the call tree - every distinct call stack has its own
+        /// frame, which accumulates the cost of the instructions executed while
+        /// it is on top of the stack.
+        struct Frame {
+                size_t parent = NO_FRAME;
+                size_t label = SourceMap::NO_LABEL;
+                Ticks ticks = 0;
+                size_t firstChild = NO_FRAME;
+                size_t nextSibling = NO_FRAME;
+        };
+
+       private:
+        SourceMap sourceMap;
+        Vector<InstructionKind> kinds;
+        Vector<Counter> counters;
+
+        Vector<Frame> frames;
+        size_t currentFrame = 0;
+        Ticks instructionStart = 0;
+
+        void enter(size_t);
+        void leave();
+
+        String framePath(size_t) const;
+        Ticks totalTicks() const;
+
+       public:
+        /// Prepares the counters for the given program, whose execution starts
+        /// at the passed instruction index.
+        Profiler(const Vector<Box<Instruction>> &, const SourceMap &, size_t);
+
+        /// Reads the current value of the clock used for measuring the costs.
+        static Ticks now() {
+#if defined(__x86_64__) || defined(__i386__)
+                return __rdtsc();
+#else
+                const auto time = std::chrono::steady_clock::now().time_since_epoch();
+                return (Ticks)std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+#endif
+        }
+
+        /// Accounts for a single execution of the instruction at the given
+        /// index, after which the VM continues to the passed next instruction.
+        void record(size_t, size_t, Ticks);
+
+        void onStart(const Vm &) {
+        }
+        void beforeInstruction(size_t) {
+                instructionStart = now();
+        }
+        void afterInstruction(size_t instructionIdx, const Vm &vm) {
+                record(instructionIdx, vm.getNextInstruction(), now() - instructionStart);
+        }
+        void onFinish(const Vm &) {
+        }
+
+        /// The number of instructions executed so far.
+        size_t totalExecutions() const;
+
+        /// Writes the call stacks in the folded format, accepted by the
+        /// flamegraph tools - one line per stack, with the frames separated by
+        /// `;` and followed by the accumulated cost.
+        void writeFoldedStacks(std::ostream &) const;
+        /// Writes the most expensive instructions and labels, sorted by their
+        /// accumulated cost.
+        void writeSummary(std::ostream &) const;
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef VORTEX_PROGRAM_H
+#define VORTEX_PROGRAM_H
+
+#include <cstddef>
+
+#include "arena.h"
+#include "collections/box.hpp"
+#include "collections/option.hpp"
+#include "collections/string.h"
+#include "collections/vector.hpp"
+#include "instructions/instructions.h"
+#include "label_table.h"
+#include "source_map.h"
+
+class LazyLinker;
+
+/// A parsed and linked program, which owns its instructions and labels. Once
+/// compiled, the program is immutable and can be executed any number of times
+/// via `Vm::run`, which removes the parsing cost from every execution.
+///
+/// The instructions and their operands are placed one after another in the
+/// arena of the program, so the executed code is contiguous in memory and is
+/// released at once.
+///
+/// A lazily linked program starts out with placeholders and links its code
+/// on the first execution of each region. Until `linkAll` is called, such a
+/// program must not be executed by several threads at once.
+class Program {
+       private:
+        /// Declared first, so that it outlives the instructions placed in it.
+        Arena arena;
+        /// Links the regions of a lazily linked program. Declared before the
+        /// instructions, so that it outlives the linked code in its arena.
+        /// Linking does not change the behavior of the program, so it is
+        /// allowed on a constant program.
+        mutable Option<Box<LazyLinker>> linker;
+        String name;
+        /// Mutable, since the placeholders of a lazily linked program are
+        /// replaced while it is executed through a constant reference, such as
+        /// by `Vm::run`. No other member is modified after construction.
+        mutable Vector<Box<Instruction>> instructions;
+        LabelTable labels;
+        SourceMap sourceMap;
+
+       public:
+        Program(const String &, Arena &&, Vector<Box<Instruction>> &&, LabelTable &&,
+                SourceMap &&, Option<Box<LazyLinker>> &&);
+        Program(Program &&) noexcept;
+        ~Program();
+
+        /// The instructions are released before the arena, which holds them.
+        Program &operator=(Program &&) noexcept;
+
+        /// The name of the source, from which the program was compiled.
+        const String &getName() const;
+        const Vector<Box<Instruction>> &getInstructions() const;
+        /// Returns the instruction index of the given label, if it is defined.
+        Option<size_t> findLabel(StringView) const;
+        const SourceMap &getSourceMap() const;
+        /// Links every region of a lazily linked program ahead of its
+        /// execution, such as before inspecting its instructions. Does nothing
+        /// for an already linked program.
+        void linkAll() const;
+
+        friend class LazyLinker;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef VORTEX_SAMPLER_H
+#define VORTEX_SAMPLER_H
+
+#include <atomic>
+#include <csignal>
+#include <cstddef>
+#include <ostream>
+#include <sys/time.h>
+
+#include "collections/vector.hpp"
+#include "source_map.h"
+#include "vm.h"
+
+/// A statistical profiler, which complements the exact `Profiler` for long
+/// running programs. A `SIGPROF` timer periodically raises a flag, which the
+/// sampler checks after each instruction as an `ExecutionObserver` policy of
+/// `Vm::execute`, so the only cost of an instruction between two samples is a
+/// single relaxed load.
+///
+/// The VM stores the call frames on the same stack as the user values, so the
+/// sampler tracks the active calls itself, as a `CallObserver` - each `call`
+/// records its location along with the stack position of its frame, which is
+/// dropped once a `return` pops the stack beneath it.
+class Sampler {
+       private:
+        /// The interval between two samples, measured in consumed CPU time.
+        static constexpr suseconds_t SAMPLING_INTERVAL_US = 1000;
+        /// The number of labels shown in the histogram.
+        static constexpr size_t HISTOGRAM_ROWS = 20;
+        static constexpr size_t HISTOGRAM_BAR_WIDTH = 40;
+
+        static_assert(std::atomic<bool>::is_always_lock_free,
+                      "The sampling flag must be safe to use inside a signal handler");
+        static std::atomic<bool> pendingSample;
+
+        static void handleSignal(int);
+
+        /// A call, which has not returned yet.
+        struct CallFrame {
+                size_t callSite;
+                /// The position of the return address on the VM stack.
+                size_t stackPosition;
+        };
+
+       private:
+        SourceMap sourceMap;
+        /// The active calls, with the innermost one last.
+        Vector<CallFrame> callFrames;
+
+        /// The samples, in which the label was on top of the stack (self) and
+        /// anywhere in the stack (total). The last entry holds the samples for
+        /// the instructions, which do not belong to any label.
+        Vector<size_t> selfSamples;
+        Vector<size_t> totalSamples;
+        /// The last sample, in which each label was counted towards its total,
+        /// so that recursive calls are not counted more than once.
+        Vector<size_t> lastSample;
+        size_t samples = 0;
+
+        bool running = false;
+        struct sigaction previousAction = {};
+        itimerval previousTimer = {};
+
+        size_t labelSlot(size_t) const;
+        void countLabel(size_t, bool);
+
+       public:
+        Sampler(const SourceMap &);
+        Sampler(const Sampler &) = delete;
+        ~Sampler();
+
+        Sampler &operator=(const Sampler &) = delete;
+
+        /// Installs the signal handler and arms the profiling timer.
+        void start();
+        /// Disarms the timer and restores the previous signal handler.
+        void stop();
+
+        bool isPending() const {
+                return pendingSample.load(std::memory_order_relaxed);
+        }
+        /// Records the current location of the VM and its callers.
+        void sample(const Vm &);
+
+        void onStart(const Vm &) {
+                start();
+        }
+        void beforeInstruction(size_t) {
+        }
+        void afterInstruction(size_t, const Vm &vm) {
+                if (isPending()) {
+                        sample(vm);
+                }
+        }
+        void onCall(size_t callSite, size_t framePosition) {
+                callFrames.pushBack(CallFrame{callSite, framePosition});
+        }
+        void onReturn(size_t framePosition) {
+                // A frame popped by a plain `pop` is dropped along with the
+                // one of the `return`.
+                while (callFrames.length() > 0 &&
+                       callFrames[callFrames.length() - 1].unwrap().stackPosition >=
+                           framePosition) {
+                        (void)callFrames.popBack();
+                }
+        }
+        void onFinish(const Vm &) {
+                stop();
+        }
+
+        /// Writes the number of samples for each label, sorted by the samples
+        /// spent directly inside the label.
+        void writeHistogram(std::ostream &) const;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef VORTEX_SOURCE_MAP_H
+#define VORTEX_SOURCE_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "collections/string.h"
+#include "collections/vector.hpp"
+#include "symbol_table.h"
+
+class Parser;
+
+/// The position of an instruction in the source code. The file is an index into
+/// the interned file names of the parser, so a location takes 8 bytes and
+/// does not own any strings.
+struct SourceLocation {
+        uint16_t file = 0;
+        /// The column, at which the instruction starts, or 0 if unknown.
+        uint16_t column = 0;
+        uint32_t line = 0;
+};
+
+/// Maps the indices of the linked instructions back to the source code - the
+/// labels, which contain them, and the files, lines and columns, on which they
+/// were declared. Used by the profilers for attributing the collected costs
+/// and for the diagnostics of the compiled program.
+class SourceMap {
+       public:
+        /// Marks the instructions, which are not preceded by any label.
+        static constexpr size_t NO_LABEL = SIZE_MAX;
+
+       private:
+        Vector<String> labelNames;
+        /// The names of the source files, referred to by the locations.
+        SymbolTable files;
+        Vector<SourceLocation> locations;
+        Vector<size_t> labelAt;
+        Vector<size_t> enclosingLabel;
+
+       public:
+        SourceMap(const Parser &);
+
+        size_t instructionCount() const;
+        size_t labelCount() const;
+        /// Returns the name of the label with the given id, or a placeholder
+        /// for `NO_LABEL`.
+        const char *labelName(size_t) const;
+
+        /// The id of the label declared exactly at the given instruction index,
+        /// or `NO_LABEL` if there is none.
+        size_t getLabelAt(size_t) const;
+        /// The id of the closest label declared at or before the given
+        /// instruction index, or `NO_LABEL` if there is none.
+        size_t getEnclosingLabel(size_t) const;
+        size_t getSourceLine(size_t) const;
+        const SourceLocation &getLocation(size_t) const;
+        /// The name of the source file with the given index.
+        const char *fileName(uint16_t) const;
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef VORTEX_STATISTICS_H
+#define VORTEX_STATISTICS_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+
+#include "collections/box.hpp"
+#include "collections/vector.hpp"
+#include "instructions/instructions.h"
+#include "source_map.h"
+#include "vm.h"
+
+/// The outcomes of a single `if` statement. The branch is considered taken
+/// when its condition holds and the guarded instruction is executed.
+struct BranchStats {
+        size_t taken = 0;
+        size_t notTaken = 0;
+};
+
+/// The aggregated counters of a single program execution.
+struct RuntimeStats {
+        size_t instructionsRetired = 0;
+        size_t calls = 0;
+        size_t returns = 0;
+        size_t maxCallDepth = 0;
+        /// The largest number of values held by the stack at once, including
+        /// the call frames.
+        size_t stackHighWater = 0;
+        std::chrono::nanoseconds wallTime{0};
+};
+
+/// Collects the `RuntimeStats` of a program, along with the outcomes of each of
+/// its `if` statements. As an `ExecutionObserver` policy of `Vm::execute`, the
+/// counters are only compiled into the dispatch loop, which is instantiated
+/// with this class - the regular `Vm::execute` does not pay for them.
+class Statistics {
+       private:
+        using Clock = std::chrono::steady_clock;
+
+        Vector<InstructionKind> kinds;
+        Vector<BranchStats> branches;
+        RuntimeStats stats;
+        size_t callDepth = 0;
+        Clock::time_point startTime;
+
+       public:
+        Statistics(const Vector<Box<Instruction>> &);
+
+        const RuntimeStats &getStats() const;
+        /// The outcomes of the `if` statement at the given instruction index.
+        /// The counters of any other instruction remain zero.
+        const BranchStats &getBranchStats(size_t) const;
+
+        void onStart(const Vm &);
+        void beforeInstruction(size_t) {
+        }
+        void afterInstruction(size_t, const Vm &);
+        void onFinish(const Vm &);
+
+        /// Writes the counters and the outcomes of the executed `if`
+        /// statements, along with their source lines.
+        void writeReport(std::ostream &, const SourceMap &) const;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef VORTEX_SYMBOL_TABLE_H
+#define VORTEX_SYMBOL_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "collections/option.hpp"
+#include "collections/string_view.h"
+#include "collections/vector.hpp"
+
+/// A compact identifier of an interned string. Symbols are handed out
+/// consecutively from 0, so they can directly index arrays.
+using Symbol = uint32_t;
+
+/// Interns strings, mapping each distinct string to a `Symbol`. The characters
+/// of all strings are stored back to back in large chunks, so interning a
+/// string costs no allocation of its own and equal strings share their storage.
+/// Comparing two interned strings is an integer comparison.
+class SymbolTable {
+       public:
+        static constexpr Symbol NO_SYMBOL = UINT32_MAX;
+
+       private:
+        static constexpr size_t CHUNK_SIZE = 4096;
+        static constexpr size_t INITIAL_SLOTS = 64;
+
+        struct Entry {
+                const char *name;
+                size_t length;
+                size_t hash;
+        };
+
+        /// The storage of the characters. A chunk is never reallocated, so the
+        /// names stay in place for the lifetime of the table.
+        Vector<char *> chunks;
+        size_t chunkUsed = CHUNK_SIZE;
+
+        Vector<Entry> entries;
+        /// An open-addressing index of the entries, whose size is a power of
+        /// two. Empty slots hold `NO_SYMBOL`. The slots are only allocated by
+        /// the first interned string, so an empty or a moved-from table holds
+        /// none.
+        Vector<Symbol> slots;
+
+        void clone(const SymbolTable &);
+        void free();
+        void move(SymbolTable &&) noexcept;
+
+        const char *store(const char *, size_t);
+        size_t findSlot(const char *, size_t, size_t) const;
+        void grow();
+
+       public:
+        SymbolTable() = default;
+        SymbolTable(const SymbolTable &);
+        SymbolTable(SymbolTable &&) noexcept;
+        ~SymbolTable();
+
+        SymbolTable &operator=(const SymbolTable &);
+        SymbolTable &operator=(SymbolTable &&) noexcept;
+
+        /// Returns the symbol of the given string, adding it to the table if
+        /// it is not interned yet.
+        Symbol intern(StringView);
+        Option<Symbol> find(StringView) const;
+
+        /// The null terminated characters of the interned string.
+        const char *name(Symbol) const;
+        size_t length(Symbol) const;
+        /// The number of interned strings.
+        size_t size() const;
+};
+
+#endif
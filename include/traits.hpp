@@ -86,26 +86,70 @@ concept Cloneable = requires(const T &value) {
 template <typename T>
 concept Moveable = std::is_move_constructible_v<T> && std::is_move_assignable_v<T>;
 
+/// Marks the types, whose objects can be moved to a new address by copying
+/// their bytes and forgetting the original, without running the move
+/// constructor and the destructor. Besides the trivially copyable types, this
+/// holds for most owning handles - they only point to memory outside of the
+/// object itself - so the collections specialize it for their own types.
+template <typename T>
+struct IsTriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+concept TriviallyRelocatable = IsTriviallyRelocatable<T>::value;
+
 class Hash {
        public:
         virtual size_t hash() const = 0;
         virtual ~Hash() = default;
 };
 
+/// The small value types, such as `String`, provide a non-virtual `hash`
+/// method instead of deriving from `Hash`, so their objects do not carry a
+/// virtual table pointer.
+template <typename T>
+concept HashMethod = requires(const T &value) {
+        { value.hash() } -> std::convertible_to<size_t>;
+};
+
 template <typename T>
-concept Hashable = std::derived_from<T, Hash> || requires(T t) {
+concept Hashable = std::derived_from<T, Hash> || HashMethod<T> || requires(T t) {
         { std::hash<T>()(t) } -> std::convertible_to<size_t>;
 };
 
 template <Hashable T>
 size_t hash(const T &value) {
-        if constexpr (std::derived_from<T, Hash>) {
+        if constexpr (std::derived_from<T, Hash> || HashMethod<T>) {
                 return value.hash();
         } else {
                 return std::hash<T>()(value);
         }
 }
 
+/// Allows looking up the keys of type `K` in the hashed collections by a value
+/// of another type `Q` - such as a string by a view of its characters - without
+/// building a temporary `K`. A specialization must hash a `Q` to the same value
+/// as the equal `K`. Every `Hashable` type can be looked up by itself.
+template <typename K, typename Q>
+struct KeyLookup;
+
+template <typename K>
+        requires Hashable<K> && Equatable<K>
+struct KeyLookup<K, K> {
+        static size_t hash(const K &key) {
+                return vortex::hash(key);
+        }
+
+        static bool equals(const K &key, const K &query) {
+                return key == query;
+        }
+};
+
+template <typename K, typename Q>
+concept LookupKey = requires(const K &key, const Q &query) {
+        { KeyLookup<K, Q>::hash(query) } -> std::convertible_to<size_t>;
+        { KeyLookup<K, Q>::equals(key, query) } -> std::convertible_to<bool>;
+};
+
 }  // namespace vortex
 
 #endif
@@ -5,6 +5,7 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "arena.h"
 #include "error.h"
 
 class Vm;
@@ -12,7 +13,10 @@ class Vm;
 /// An abstract class, representing anything which can be interpreted as a value
 /// in the language. In C++ terms, this `Value` type is neither lvalue, nor
 /// rvalue, but merely a label, unifying both when applicable.
-class Value {
+///
+/// The operands of the instructions in a compiled `Program` are placed in its
+/// arena, next to the instructions themselves.
+class Value : public ArenaAllocated {
        public:
         virtual double getValue(const Vm &) const = 0;
         virtual ~Value() = default;
@@ -3,13 +3,53 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <initializer_list>
 #include <iostream>
 #include <vector>
 
+#include "collections/string_view.h"
 #include "collections/vector.hpp"
 #include "instructions/instructions.h"
 #include "value.h"
 
+class Vm;
+class Program;
+
+/// The interface of the policies, which instrument the execution of a program
+/// inside `Vm::execute`. The hooks are resolved at compile time, so a policy
+/// with empty hooks (such as `NoObserver`) costs nothing at runtime.
+template <typename T>
+concept ExecutionObserver = requires(T observer, const Vm &vm, size_t instructionIdx) {
+        observer.onStart(vm);
+        observer.beforeInstruction(instructionIdx);
+        observer.afterInstruction(instructionIdx, vm);
+        observer.onFinish(vm);
+};
+
+/// The policies, which also track the calls and returns. Their hooks are
+/// invoked by the `call` and `return` instructions themselves, so tracking the
+/// calls adds nothing to the dispatch of the other instructions. Both hooks
+/// receive the stack position of the frame - `onCall` along with the index of
+/// the `call` instruction.
+template <typename T>
+concept CallObserver =
+    ExecutionObserver<T> && requires(T observer, size_t instructionIdx, size_t stackPosition) {
+            observer.onCall(instructionIdx, stackPosition);
+            observer.onReturn(stackPosition);
+    };
+
+/// The default execution policy, which does not collect anything.
+struct NoObserver {
+        void onStart(const Vm &) {
+        }
+        void beforeInstruction(size_t) {
+        }
+        void afterInstruction(size_t, const Vm &) {
+        }
+        void onFinish(const Vm &) {
+        }
+};
+
 /// The core of the whole language, used to execute the parsed user programs.
 /// This implementation follows the register based virtual machine architecture,
 /// which allows for more powerful instructions, but harder to programatically
@@ -20,23 +60,80 @@ class Vm {
         static constexpr size_t REGISTER_COUNT = 16;
         static constexpr size_t STACK_FRAMES = 4096;
 
+       private:
+        /// The hooks of the `CallObserver`, which currently executes a
+        /// program, with the observer's type erased.
+        struct CallHooks {
+                void *observer = nullptr;
+                void (*onCall)(void *, size_t, size_t) = nullptr;
+                void (*onReturn)(void *, size_t) = nullptr;
+        };
+
+        /// Installs the hooks of the observer for the lifetime of the scope,
+        /// restoring the previous ones afterwards, even if the execution
+        /// throws.
+        class CallHooksScope {
+               private:
+                Vm &vm;
+                CallHooks previous;
+
+               public:
+                template <ExecutionObserver Observer>
+                CallHooksScope(Vm &, Observer &);
+                CallHooksScope(const CallHooksScope &) = delete;
+                ~CallHooksScope();
+
+                CallHooksScope &operator=(const CallHooksScope &) = delete;
+        };
+
        private:
         size_t nextInstruction = 0;
-        double registers[REGISTER_COUNT];
+        double registers[REGISTER_COUNT] = {};
 
         Vector<double> stack;
+        CallHooks callHooks;
 
        public:
         Vm() = default;
+        /// Builds a VM, whose stack is allocated from the given resource.
+        Vm(MemoryResource &);
 
         void execute(const Vector<Box<Instruction>> &);
+        /// Executes the program, while notifying the observer before and after
+        /// every executed instruction. Used for profiling and for collecting
+        /// runtime statistics.
+        template <ExecutionObserver Observer>
+        void execute(const Vector<Box<Instruction>> &, Observer &);
+
+        /// Resets the VM and executes the program, starting from the given
+        /// label. The arguments are loaded into the registers, starting from
+        /// `r0`, and the results can be read back from the registers after the
+        /// execution. The label may end with a `return`, which finishes the
+        /// execution. Throws `UnknownLabelException` if the label is not
+        /// defined.
+        void run(const Program &, StringView, std::initializer_list<double> = {});
+        /// Clears the registers, the stack and the instruction pointer. The
+        /// memory of the stack is kept for the next execution.
+        void reset();
+
+        /// Accesses the register with the given index, without the validation
+        /// of a `Register` value.
+        double getRegister(size_t) const;
+        void setRegister(size_t, double);
         double getRegister(const Register &) const;
+        /// The contents of all registers, used by the host functions for
+        /// reading their arguments.
+        const double *getRegisters() const;
         void setRegister(const Register &, double);
 
         size_t getNextInstruction() const;
         void setNextInstruction(size_t);
         void goToNextInstruction();
 
+        /// The program stack, holding both the pushed values and the call
+        /// frames.
+        const Vector<double> &getStack() const;
+
         void push(double);
         double pop();
 
@@ -45,6 +142,53 @@ class Vm {
         /// Pops the top value off the stack and interprets it as an instruction
         /// location.
         size_t popCallFrame();
+
+        /// Notifies the executing `CallObserver`, if any, of a call made by the
+        /// instruction at the given index, after its frame is pushed.
+        void notifyCall(size_t callSite) {
+                if (callHooks.observer != nullptr) {
+                        callHooks.onCall(callHooks.observer, callSite, stack.length() - 1);
+                }
+        }
+        /// Notifies the executing `CallObserver`, if any, of a return, after
+        /// its frame is popped.
+        void notifyReturn() {
+                if (callHooks.observer != nullptr) {
+                        callHooks.onReturn(callHooks.observer, stack.length());
+                }
+        }
 };
 
+template <ExecutionObserver Observer>
+Vm::CallHooksScope::CallHooksScope(Vm &_vm, Observer &observer)
+    : vm(_vm), previous(_vm.callHooks) {
+        if constexpr (CallObserver<Observer>) {
+                vm.callHooks.observer = &observer;
+                vm.callHooks.onCall = [](void *erased, size_t callSite, size_t framePosition) {
+                        static_cast<Observer *>(erased)->onCall(callSite, framePosition);
+                };
+                vm.callHooks.onReturn = [](void *erased, size_t framePosition) {
+                        static_cast<Observer *>(erased)->onReturn(framePosition);
+                };
+        }
+}
+
+inline Vm::CallHooksScope::~CallHooksScope() {
+        vm.callHooks = previous;
+}
+
+template <ExecutionObserver Observer>
+void Vm::execute(const Vector<Box<Instruction>> &instructions, Observer &observer) {
+        const CallHooksScope hooks(*this, observer);
+        observer.onStart(*this);
+        while (nextInstruction < instructions.length()) {
+                const size_t current = nextInstruction;
+                const Box<Instruction> &instr = instructions[current].unwrap();
+                observer.beforeInstruction(current);
+                instr->execute(*this);
+                observer.afterInstruction(current, *this);
+        }
+        observer.onFinish(*this);
+}
+
 #endif
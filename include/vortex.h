@@ -2,21 +2,60 @@
 #define VORTEX_H
 
 #include "parser.h"
+#include "program.h"
 #include "vm.h"
 
-/// An user-facing abstraction of the `vortex` language. Currently the purpose
-/// is to encapsulate the CLI logic from the implementation, but could also
-/// serve for internal purposes of integrating into other applications, which
-/// require runtime compilation of code.
+/// An user-facing abstraction of the `vortex` language. Encapsulates the CLI
+/// logic from the implementation and serves as the entry point for integrating
+/// into other applications, which compile a script once via `compile` and then
+/// execute it as many times as needed via `Vm::run`.
 class Vortex {
+       public:
+        /// Selects how the scripts are executed.
+        enum class Mode {
+                /// Executes the script without any instrumentation.
+                Run,
+                /// Counts the executions and the cost of every instruction and
+                /// prints them after the execution.
+                Profile,
+                /// Periodically samples the executed label and prints the
+                /// histogram of the samples after the execution.
+                Sample,
+                /// Collects the runtime statistics of the VM, such as the call
+                /// depth and the stack usage, and prints them after the
+                /// execution.
+                Stats,
+        };
+
        private:
         static constexpr const char *ENTRYPOINT_LABEL = "main";
+        /// Appended to the script name to form the file, which receives the
+        /// folded call stacks when profiling.
+        static constexpr const char *FOLDED_STACKS_EXTENSION = ".folded";
 
        private:
         Vm vm;
-        Parser parser;
+        Mode mode = Mode::Run;
+        bool lazyLinking = false;
+
+        void profile(const Program &, size_t);
+        void sample(const Program &);
+        void collectStats(const Program &);
 
        public:
+        /// Parses and links the given source code into a `Program`. The name is
+        /// only used for the error messages.
+        static Program compile(const String &source, const String &name = "<source>");
+        /// Parses and links the given source file into a `Program`.
+        static Program compileFile(const String &filename);
+
+        /// Any reports of the profiling modes are printed to the standard
+        /// error, so that they do not mix with the output of the script.
+        void setMode(Mode);
+        /// Toggles the lazy linking of the executed scripts, so that only the
+        /// executed code is linked. The profiling modes still link the whole
+        /// script before the execution.
+        void setLazyLinking(bool);
         void execute(const String &);
         static void showSynopsis();
 };
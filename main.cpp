@@ -5,15 +5,33 @@
 
 int main(int argc, char* argv[]) {
         Vortex vortex;
-        if (argc != 2) {
+        const char* script = nullptr;
+        for (int i = 1; i < argc; ++i) {
+                if (0 == strcmp(argv[i], "--profile")) {
+                        vortex.setMode(Vortex::Mode::Profile);
+                } else if (0 == strcmp(argv[i], "--sample")) {
+                        vortex.setMode(Vortex::Mode::Sample);
+                } else if (0 == strcmp(argv[i], "--stats")) {
+                        vortex.setMode(Vortex::Mode::Stats);
+                } else if (0 == strcmp(argv[i], "--lazy")) {
+                        vortex.setLazyLinking(true);
+                } else if (nullptr == script) {
+                        script = argv[i];
+                } else {
+                        script = nullptr;
+                        break;
+                }
+        }
+
+        if (nullptr == script) {
                 vortex.showSynopsis();
                 return 1;
         }
 
-        if (0 == strcmp(argv[1], "help")) {
+        if (0 == strcmp(script, "help")) {
                 vortex.showSynopsis();
         } else {
-                vortex.execute(argv[1]);
+                vortex.execute(script);
         }
 
         return 0;
@@ -0,0 +1,146 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+thread_local Arena *Arena::current = nullptr;
+
+/// Rounds the address up to the given alignment, which is a power of two.
+static uintptr_t alignUp(uintptr_t address, size_t alignment) {
+        return (address + alignment - 1) & ~(uintptr_t)(alignment - 1);
+}
+
+Arena::Scope::Scope(Arena &arena) : previous(current) {
+        current = &arena;
+}
+
+Arena::Scope::~Scope() {
+        current = previous;
+}
+
+void Arena::free() {
+        // The objects are destroyed in reverse order of creation, since the
+        // later ones may refer to the earlier ones.
+        while (destructors.length() > 0) {
+                const Destructor destructor = destructors.popBack().unwrap();
+                destructor.destroy(destructor.object);
+        }
+        for (char *chunk : chunks) {
+                ::operator delete(chunk, std::align_val_t(alignof(std::max_align_t)));
+        }
+        chunks.clear();
+        cursor = nullptr;
+        limit = nullptr;
+        used = 0;
+}
+
+void Arena::move(Arena &&other) noexcept {
+        chunks = std::move(other.chunks);
+        destructors = std::move(other.destructors);
+        cursor = other.cursor;
+        limit = other.limit;
+        used = other.used;
+        other.cursor = nullptr;
+        other.limit = nullptr;
+        other.used = 0;
+}
+
+void *Arena::allocateChunk(size_t size, size_t alignment) {
+        // Oversized allocations get a chunk of their own and the current chunk
+        // keeps serving the smaller ones. The chunks are only aligned to
+        // `max_align_t`, so the room for aligning the allocation inside the
+        // chunk is reserved up front.
+        const size_t chunkSize = std::max(CHUNK_SIZE, size + alignment);
+        char *chunk = static_cast<char *>(
+            ::operator new(chunkSize, std::align_val_t(alignof(std::max_align_t))));
+        chunks.pushBack(chunk);
+        char *result =
+            reinterpret_cast<char *>(alignUp(reinterpret_cast<uintptr_t>(chunk), alignment));
+        if (chunkSize > CHUNK_SIZE) {
+                return result;
+        }
+        cursor = result + size;
+        limit = chunk + chunkSize;
+        return result;
+}
+
+Arena::Arena(Arena &&other) noexcept {
+        move(std::move(other));
+}
+
+Arena::~Arena() {
+        free();
+}
+
+Arena &Arena::operator=(Arena &&other) noexcept {
+        if (this != &other) {
+                free();
+                move(std::move(other));
+        }
+        return *this;
+}
+
+void *Arena::allocate(size_t size, size_t alignment) {
+        used += size;
+        const uintptr_t aligned = alignUp(reinterpret_cast<uintptr_t>(cursor), alignment);
+        if (cursor != nullptr && aligned + size <= reinterpret_cast<uintptr_t>(limit)) {
+                cursor = reinterpret_cast<char *>(aligned + size);
+                return reinterpret_cast<void *>(aligned);
+        }
+        return allocateChunk(size, alignment);
+}
+
+void Arena::deallocate(void *, size_t, size_t) {
+}
+
+void Arena::adopt(Arena &&other) {
+        if (this == &other) {
+                return;
+        }
+        for (char *chunk : other.chunks) {
+                chunks.pushBack(chunk);
+        }
+        for (const Destructor &destructor : other.destructors) {
+                destructors.pushBack(destructor);
+        }
+        used += other.used;
+        other.chunks.clear();
+        other.destructors.clear();
+        other.cursor = nullptr;
+        other.limit = nullptr;
+        other.used = 0;
+}
+
+void Arena::reset() {
+        free();
+}
+
+size_t Arena::bytesUsed() const {
+        return used;
+}
+
+Arena *Arena::getCurrent() {
+        return current;
+}
+
+void *ArenaAllocated::operator new(size_t size) {
+        Arena *arena = Arena::getCurrent();
+        char *memory = nullptr;
+        if (arena != nullptr) {
+                memory = static_cast<char *>(arena->allocate(HEADER_SIZE + size));
+        } else {
+                memory = static_cast<char *>(::operator new(HEADER_SIZE + size));
+        }
+        *reinterpret_cast<bool *>(memory) = arena != nullptr;
+        return memory + HEADER_SIZE;
+}
+
+void ArenaAllocated::operator delete(void *object) {
+        if (nullptr == object) {
+                return;
+        }
+        char *memory = static_cast<char *>(object) - HEADER_SIZE;
+        if (!*reinterpret_cast<bool *>(memory)) {
+                ::operator delete(memory);
+        }
+}
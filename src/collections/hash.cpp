@@ -0,0 +1,85 @@
+#include "collections/hash.h"
+
+#include <cstdint>
+#include <cstring>
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+static constexpr uint64_t SECRET[4] = {
+    0xa0761d6478bd642fULL,
+    0xe7037ed1a0b428dbULL,
+    0x8ebc6af09c88c6e3ULL,
+    0x589965cc75374cc3ULL,
+};
+
+/// Multiplies the two words into 128 bits and folds the halves together.
+static uint64_t mix(uint64_t a, uint64_t b) {
+        const uint128_t product = (uint128_t)a * b;
+        return (uint64_t)product ^ (uint64_t)(product >> 64);
+}
+
+// The unaligned reads are done through `memcpy`, which the compiler turns
+// into single loads.
+static uint64_t read64(const char *bytes) {
+        uint64_t result;
+        (void)memcpy(&result, bytes, sizeof(result));
+        return result;
+}
+
+static uint64_t read32(const char *bytes) {
+        uint32_t result;
+        (void)memcpy(&result, bytes, sizeof(result));
+        return result;
+}
+
+/// Reads 1 to 3 bytes, covering each of them without branching on the length.
+static uint64_t readSmall(const char *bytes, size_t length) {
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(bytes);
+        return ((uint64_t)data[0] << 16) | ((uint64_t)data[length >> 1] << 8) | data[length - 1];
+}
+
+size_t vortex::hashBytes(const char *bytes, size_t length) {
+        uint64_t seed = mix(SECRET[0], SECRET[1]);
+        uint64_t a = 0;
+        uint64_t b = 0;
+
+        if (length <= 16) {
+                // Short inputs are read as two possibly overlapping pairs of
+                // words from both of their ends.
+                if (length >= 4) {
+                        const size_t offset = (length >> 3) << 2;
+                        a = (read32(bytes) << 32) | read32(bytes + offset);
+                        b = (read32(bytes + length - 4) << 32) | read32(bytes + length - 4 - offset);
+                } else if (length > 0) {
+                        a = readSmall(bytes, length);
+                }
+        } else {
+                const char *data = bytes;
+                size_t left = length;
+                if (left > 48) {
+                        // Three independent lanes keep the multipliers busy.
+                        uint64_t lane1 = seed;
+                        uint64_t lane2 = seed;
+                        do {
+                                seed = mix(read64(data) ^ SECRET[1], read64(data + 8) ^ seed);
+                                lane1 = mix(read64(data + 16) ^ SECRET[2], read64(data + 24) ^ lane1);
+                                lane2 = mix(read64(data + 32) ^ SECRET[3], read64(data + 40) ^ lane2);
+                                data += 48;
+                                left -= 48;
+                        } while (left > 48);
+                        seed ^= lane1 ^ lane2;
+                }
+                while (left > 16) {
+                        seed = mix(read64(data) ^ SECRET[1], read64(data + 8) ^ seed);
+                        data += 16;
+                        left -= 16;
+                }
+                a = read64(data + left - 16);
+                b = read64(data + left - 8);
+        }
+
+        const uint128_t product = (uint128_t)(a ^ SECRET[1]) * (b ^ seed);
+        a = (uint64_t)product;
+        b = (uint64_t)(product >> 64);
+        return (size_t)mix(a ^ SECRET[0] ^ length, b ^ SECRET[1]);
+}
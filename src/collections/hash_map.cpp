@@ -0,0 +1,8 @@
+#include "collections/hash_map.hpp"
+
+HashMapException::HashMapException(const String &msg) : message(msg) {
+}
+
+const char *HashMapException::what() const noexcept {
+        return message.cStr();
+}
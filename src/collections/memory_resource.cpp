@@ -0,0 +1,99 @@
+#include "collections/memory_resource.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+void *MemoryResource::allocate(MemoryResource *resource, size_t size, size_t alignment) {
+        if (nullptr == resource) {
+                return ::operator new(size, std::align_val_t(alignment));
+        }
+        return resource->allocate(size, alignment);
+}
+
+void MemoryResource::deallocate(MemoryResource *resource, void *ptr, size_t size,
+                                size_t alignment) {
+        if (nullptr == resource) {
+                ::operator delete(ptr, std::align_val_t(alignment));
+                return;
+        }
+        resource->deallocate(ptr, size, alignment);
+}
+
+size_t PoolResource::sizeClass(size_t size) {
+        size_t result = 0;
+        for (size_t block = MIN_BLOCK; block < size; block *= 2) {
+                result += 1;
+        }
+        return result;
+}
+
+/// The offset of the first address past the pointer, which is a multiple of
+/// the given power of two.
+static size_t alignmentPadding(const char *ptr, size_t alignment) {
+        return (alignment - reinterpret_cast<uintptr_t>(ptr) % alignment) % alignment;
+}
+
+char *PoolResource::carve(size_t blockSize) {
+        // Each block is aligned to its size by rounding up its address, so the
+        // upstream only needs to align the chunks to `max_align_t`.
+        if (cursor != nullptr) {
+                cursor += std::min(alignmentPadding(cursor, blockSize), (size_t)(limit - cursor));
+        }
+        if (cursor == nullptr || (size_t)(limit - cursor) < blockSize) {
+                char *memory = static_cast<char *>(
+                    MemoryResource::allocate(upstream, CHUNK_SIZE, alignof(std::max_align_t)));
+                Chunk *chunk = reinterpret_cast<Chunk *>(memory);
+                chunk->next = chunks;
+                chunks = chunk;
+                cursor = memory + sizeof(Chunk);
+                cursor += alignmentPadding(cursor, blockSize);
+                limit = memory + CHUNK_SIZE;
+        }
+        char *block = cursor;
+        cursor += blockSize;
+        return block;
+}
+
+PoolResource::PoolResource(MemoryResource *_upstream) : upstream(_upstream) {
+}
+
+PoolResource::~PoolResource() {
+        while (chunks != nullptr) {
+                Chunk *next = chunks->next;
+                MemoryResource::deallocate(upstream, chunks, CHUNK_SIZE, alignof(std::max_align_t));
+                chunks = next;
+        }
+}
+
+void *PoolResource::allocate(size_t size, size_t alignment) {
+        if (size > MAX_BLOCK || alignment > MAX_BLOCK) {
+                return MemoryResource::allocate(upstream, size, alignment);
+        }
+        // A block is aligned to its own size, so it suits any alignment up to
+        // the size class.
+        const size_t idx = sizeClass(size > alignment ? size : alignment);
+        FreeBlock *block = freeLists[idx];
+        if (block != nullptr) {
+                freeLists[idx] = block->next;
+                return block;
+        }
+        return carve(MIN_BLOCK << idx);
+}
+
+void PoolResource::deallocate(void *ptr, size_t size, size_t alignment) {
+        if (size > MAX_BLOCK || alignment > MAX_BLOCK) {
+                MemoryResource::deallocate(upstream, ptr, size, alignment);
+                return;
+        }
+        const size_t idx = sizeClass(size > alignment ? size : alignment);
+        FreeBlock *block = static_cast<FreeBlock *>(ptr);
+        block->next = freeLists[idx];
+        freeLists[idx] = block;
+}
+
+PoolResource &PoolResource::getThreadLocal() {
+        static thread_local PoolResource pool;
+        return pool;
+}
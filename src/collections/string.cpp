@@ -5,55 +5,117 @@
 #include <cstring>
 #include <iostream>
 
-void String::realloc(size_t size) {
-        this->cap = size;
-        this->len = std::min(this->len, this->cap);
+bool String::isInline() const {
+        return cap == INLINE_CAPACITY;
+}
+
+char *String::buffer() {
+        return isInline() ? local : heap;
+}
+
+const char *String::buffer() const {
+        return isInline() ? local : heap;
+}
+
+char *String::allocate(size_t capacity) {
+        return static_cast<char *>(MemoryResource::allocate(resource, capacity + 1, alignof(char)));
+}
 
-        char *newStr = new char[this->cap + 1];
-        strncpy(newStr, this->str, this->len);
-        newStr[this->len] = '\0';
-        delete[] this->str;
-        this->str = newStr;
+void String::deallocate(char *str, size_t capacity) {
+        MemoryResource::deallocate(resource, str, capacity + 1, alignof(char));
+}
+
+void String::realloc(size_t size) {
+        const size_t newCap = std::max(size, INLINE_CAPACITY);
+        if (newCap == cap) {
+                return;
+        }
+        this->len = std::min(this->len, newCap);
+
+        if (newCap == INLINE_CAPACITY) {
+                char *oldStr = this->heap;
+                (void)memcpy(this->local, oldStr, this->len);
+                deallocate(oldStr, this->cap);
+        } else {
+                char *newStr = allocate(newCap);
+                (void)memcpy(newStr, buffer(), this->len);
+                if (!isInline()) {
+                        deallocate(this->heap, this->cap);
+                }
+                this->heap = newStr;
+        }
+        this->cap = newCap;
+        this->cachedHash = 0;
+        buffer()[this->len] = '\0';
 }
 
 void String::free() {
-        delete[] this->str;
-        this->str = nullptr;
+        if (!isInline()) {
+                deallocate(this->heap, this->cap);
+        }
+        this->cap = INLINE_CAPACITY;
         this->len = 0;
-        this->cap = 0;
+        this->cachedHash = 0;
+        this->local[0] = '\0';
 }
 
 void String::copy(const String &other) {
         this->len = other.len;
-        this->cap = other.cap;
-        this->str = new char[this->cap + 1];
-        memcpy(this->str, other.str, this->len);
-        this->str[this->len] = '\0';
+        this->cap = std::max(other.len, INLINE_CAPACITY);
+        this->cachedHash = other.cachedHash;
+        if (!isInline()) {
+                this->heap = allocate(this->cap);
+        }
+        (void)memcpy(buffer(), other.buffer(), this->len);
+        buffer()[this->len] = '\0';
 }
 
 void String::move(String &&other) noexcept {
-        this->str = other.str;
         this->len = other.len;
         this->cap = other.cap;
-        other.str = nullptr;
+        this->cachedHash = other.cachedHash;
+        this->resource = other.resource;
+        if (isInline()) {
+                (void)memcpy(this->local, other.local, this->len + 1);
+        } else {
+                this->heap = other.heap;
+        }
+        other.cap = INLINE_CAPACITY;
         other.len = 0;
-        other.cap = 0;
+        other.cachedHash = 0;
+        other.local[0] = '\0';
 }
 
-String::String() : len(0), cap(DEFAULT_CAPACITY) {
-        this->str = new char[this->cap + 1];
-        this->str[0] = '\0';
+String::String() : len(0), cap(INLINE_CAPACITY) {
+        this->local[0] = '\0';
 }
 
-String::String(size_t capacity) : len(0), cap(capacity) {
-        this->str = new char[this->cap + 1];
-        this->str[0] = '\0';
+String::String(size_t capacity) : len(0), cap(std::max(capacity, INLINE_CAPACITY)) {
+        if (!isInline()) {
+                this->heap = allocate(this->cap);
+        }
+        buffer()[0] = '\0';
 }
 
-String::String(const char *_str) : len(strlen(_str)), cap(len) {
-        this->str = new char[this->cap + 1];
-        (void)memcpy(this->str, _str, this->len);
-        this->str[this->len] = '\0';
+String::String(MemoryResource &_resource) : len(0), cap(INLINE_CAPACITY), resource(&_resource) {
+        this->local[0] = '\0';
+}
+
+String::String(const char *_str, MemoryResource &_resource) : String(_resource) {
+        realloc(strlen(_str));
+        append(_str);
+}
+
+String::String(const char *_str) : String(strlen(_str)) {
+        this->len = strlen(_str);
+        (void)memcpy(buffer(), _str, this->len);
+        buffer()[this->len] = '\0';
+}
+
+String::String(StringView view) : String(view.length()) {
+        this->len = view.length();
+        (void)memcpy(buffer(), view.data(), this->len);
+        buffer()[this->len] = '\0';
 }
 
 String::String(const String &other) {
@@ -69,16 +131,16 @@ String::~String() {
 }
 
 String String::fromNumber(size_t number) {
-        String result;
-        size_t reversed = 0;
-        while (number > 0) {
-                reversed = reversed * 10 + (number % 10);
-                number /= 10;
+        size_t divisor = 1;
+        while (number / divisor >= 10) {
+                divisor *= 10;
         }
-        while (reversed > 0) {
-                const char digit = '0' + (char)(reversed % 10);
+
+        String result;
+        while (divisor > 0) {
+                const char digit = '0' + (char)(number / divisor % 10);
                 result.append(digit);
-                reversed /= 10;
+                divisor /= 10;
         }
         return result;
 }
@@ -117,8 +179,9 @@ String String::operator+(char c) const {
 }
 
 String String::operator+(const String &other) const {
-        String result(*this);
-        result.append(other.str);
+        String result(len + other.len);
+        result.append(cStr());
+        result.append(other.cStr());
         return result;
 }
 
@@ -135,36 +198,41 @@ size_t String::length() const {
 }
 
 const char *String::cStr() const {
-        return str;
+        return buffer();
+}
+
+String::operator StringView() const {
+        return StringView(buffer(), len);
 }
 
 void String::append(char c) {
         if (len == cap) {
-                cap = (size_t)((double)cap * ALLOCATOR_COEF);
-                realloc(cap);
+                realloc((size_t)((double)cap * ALLOCATOR_COEF));
         }
+        cachedHash = 0;
+        char *str = buffer();
         str[len++] = c;
         str[len] = '\0';
 }
 
 void String::append(const char *added) {
-        size_t addedLen = strlen(added);
-        if (len + addedLen >= cap) {
-                cap = (size_t)((double)(len + addedLen) * ALLOCATOR_COEF);
-                realloc(cap);
+        const size_t addedLen = strlen(added);
+        if (len + addedLen > cap) {
+                realloc((size_t)((double)(len + addedLen) * ALLOCATOR_COEF));
         }
-        (void)memcpy(str + len, added, addedLen);
-        str[len + addedLen] = '\0';
+        cachedHash = 0;
+        char *str = buffer();
+        (void)memmove(str + len, added, addedLen);
         len += addedLen;
         str[len] = '\0';
 }
 
 bool String::startsWith(char c) const {
-        return str[0] == c;
+        return buffer()[0] == c;
 }
 
 bool String::endsWith(char c) const {
-        return str[len - 1] == c;
+        return len > 0 && buffer()[len - 1] == c;
 }
 
 bool String::isEmpty() const {
@@ -172,6 +240,7 @@ bool String::isEmpty() const {
 }
 
 bool String::all(bool (*predicate)(char)) const {
+        const char *str = buffer();
         for (size_t i = 0; i < len; ++i) {
                 if (!predicate(str[i])) {
                         return false;
@@ -181,30 +250,17 @@ bool String::all(bool (*predicate)(char)) const {
 }
 
 String String::between(const char *start, const char *end) {
-        size_t len = (size_t)(end - start);
-        String result(len + 1);
-        (void)strncpy(result.str, start, len);
-        result.str[len] = '\0';
+        const size_t len = (size_t)(end - start);
+        String result(len);
+        (void)memcpy(result.buffer(), start, len);
+        result.buffer()[len] = '\0';
         result.len = len;
         return result;
 }
 
 Vector<String> String::split(char delimiter) const {
         Vector<String> result;
-        const char *start = str;
-        const char *end = strchr(start, delimiter);
-        while (end != nullptr) {
-                if (start != end) {
-                        String res = between(start, end);
-                        result.pushBack(std::move(res));
-                }
-                start = end + 1;
-                end = strchr(start, delimiter);
-        }
-        if (*start != '\0') {
-                String res = between(start, str + len);
-                result.pushBack(std::move(res));
-        }
+        splitInto(delimiter, result);
         return result;
 }
 
@@ -212,22 +268,25 @@ String String::substr(size_t startIdx, size_t endIdx) const {
         if (startIdx > endIdx || startIdx > len || endIdx > len) {
                 throw std::out_of_range("Invalid substring range");
         }
-        return between(str + startIdx, str + endIdx);
+        return between(buffer() + startIdx, buffer() + endIdx);
 }
 
 void String::truncateAfter(char c) {
+        char *str = buffer();
         char *pos = strchr(str, c);
         if (pos != nullptr) {
                 *pos = '\0';
                 len = (size_t)(pos - str);
+                cachedHash = 0;
         }
 }
 
-static bool isWhitespace(char c) {
+bool isWhitespace(char c) {
         return c == ' ' || c == '\t' || c == '\n';
 }
 
 String String::trim() const {
+        const char *str = buffer();
         size_t start = 0;
         while (start < len && isWhitespace(str[start])) {
                 ++start;
@@ -241,14 +300,15 @@ String String::trim() const {
 
 vortex::Ordering String::compare(const String &other) const {
         const size_t minLen = std::min(len, other.len);
-        const int cmp = strncmp(str, other.str, minLen);
+        const int cmp = memcmp(buffer(), other.buffer(), minLen);
         if (cmp < 0) {
                 return vortex::Ordering::Less;
         }
         if (cmp > 0) {
                 return vortex::Ordering::Greater;
         }
-        return vortex::Ordering::Equal;
+        // When one string is a prefix of the other, the shorter one is less.
+        return vortex::compare(len, other.len);
 }
 
 bool operator<(const String &lhs, const String &rhs) {
@@ -264,11 +324,10 @@ bool operator==(const String &lhs, const String &rhs) {
 }
 
 size_t String::hash() const {
-        size_t result = 0;
-        for (size_t i = 0; i < len; ++i) {
-                result = result * 31 + (size_t)str[i];
+        if (cachedHash == 0) {
+                cachedHash = vortex::hashBytes(buffer(), len);
         }
-        return result;
+        return cachedHash;
 }
 
 bool isAlpha(char c) {
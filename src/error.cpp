@@ -1,27 +1,20 @@
 
 #include "error.h"
 
-void Context::clone(const Context &other) {
-        this->ln = other.ln;
-        this->filename = other.filename;
-}
-
-Context::Context(const String &_filename) : ln(0), filename(_filename) {
-}
-
-Context::Context(const Context &other) {
-        clone(other);
-}
-
-Context &Context::operator=(const Context &other) {
-        if (this != &other) {
-                clone(other);
-        }
-        return *this;
+Context::Context(StringView _filename) : filename(_filename) {
 }
 
 String Context::messageContext() const {
-        return String("[") + filename + ": " + String::fromNumber(ln) + "] ";
+        String result("[");
+        result.append(String(filename).cStr());
+        result.append(": ");
+        result.append(String::fromNumber(ln).cStr());
+        if (column > 0) {
+                result.append(':');
+                result.append(String::fromNumber(column).cStr());
+        }
+        result.append("] ");
+        return result;
 }
 
 VortexException::VortexException(const Context &ctx, const String &msg)
@@ -69,6 +62,11 @@ UnknownInstructionException::UnknownInstructionException(const Context &ctx,
     : VortexException(ctx, "Unknown instruction: " + instruction) {
 }
 
+UnknownHostFunctionException::UnknownHostFunctionException(const Context &ctx,
+                                                           const String &name)
+    : VortexException(ctx, "Unknown host function: " + name) {
+}
+
 MissingEntryPointException::MissingEntryPointException(const Context &ctx)
     : VortexException(ctx, "No entry point found (label `main` is not defined)") {
 }
@@ -0,0 +1,40 @@
+#include "host_function.h"
+
+#include <stdexcept>
+
+#include "vm.h"
+
+HostFunctions HostFunctions::GLOBAL_HOST_FUNCTIONS;
+
+HostFunction::HostFunction(Raw fn) : function(reinterpret_cast<Erased>(fn)), trampoline(invokeRaw) {
+}
+
+double HostFunction::invokeRaw(Erased fn, Vm &vm, const double *) {
+        return reinterpret_cast<Raw>(fn)(vm);
+}
+
+double HostFunction::operator()(Vm &vm) const {
+        return trampoline(function, vm, vm.getRegisters());
+}
+
+void HostFunctions::define(StringView name, HostFunction function) {
+        static const String ALREADY_DEFINED_MSG = "Host function is already defined: ";
+        if (names.find(name).isSome()) {
+                const String msg = ALREADY_DEFINED_MSG + String(name);
+                throw std::invalid_argument(msg.cStr());
+        }
+        names.intern(name);
+        functions.pushBack(function);
+}
+
+Option<HostFunction> HostFunctions::find(StringView name) const {
+        const Option<Symbol> symbol = names.find(name);
+        if (symbol.isNone()) {
+                return Option<HostFunction>();
+        }
+        return Option<HostFunction>(functions[symbol.unwrap()].unwrap());
+}
+
+HostFunctions &HostFunctions::getGlobal() {
+        return GLOBAL_HOST_FUNCTIONS;
+}
@@ -17,6 +17,10 @@ void Jmp::execute(Vm &vm) const {
         vm.setNextInstruction(location);
 }
 
+void Jmp::patchLabelLocation(size_t _location) {
+        location = _location;
+}
+
 Call::Call(size_t _location) : location(_location) {
 }
 
@@ -28,9 +32,28 @@ Box<Instruction> Call::factory(AsmReader reader) {
 
 void Call::execute(Vm &vm) const {
         vm.pushCallFrame();
+        vm.notifyCall(vm.getNextInstruction());
         vm.setNextInstruction(location);
 }
 
+void Call::patchLabelLocation(size_t _location) {
+        location = _location;
+}
+
+NativeCall::NativeCall(const HostFunction &_function) : function(_function) {
+}
+
+Box<Instruction> NativeCall::factory(AsmReader reader) {
+        const HostFunction function = reader.expectHostFunction();
+        reader.expectEndOfArgs();
+        return new NativeCall(function);
+}
+
+void NativeCall::execute(Vm &vm) const {
+        vm.setRegister(size_t(0), function(vm));
+        vm.goToNextInstruction();
+}
+
 Box<Instruction> Return::factory(AsmReader reader) {
         reader.expectEndOfArgs();
         return new Return();
@@ -40,5 +63,6 @@ void Return::execute(Vm &vm) const {
         size_t location = vm.popCallFrame();
         vm.setNextInstruction(location);
         vm.goToNextInstruction();
+        vm.notifyReturn();
 }
 
@@ -0,0 +1,14 @@
+#include "instructions/instructions.h"
+
+InstructionKind classifyInstruction(const Instruction &instr) {
+        if (dynamic_cast<const Call *>(&instr) != nullptr) {
+                return InstructionKind::Call;
+        }
+        if (dynamic_cast<const Return *>(&instr) != nullptr) {
+                return InstructionKind::Return;
+        }
+        if (dynamic_cast<const IfStmt *>(&instr) != nullptr) {
+                return InstructionKind::Branch;
+        }
+        return InstructionKind::Other;
+}
@@ -1,6 +1,8 @@
 
 #include "instructions/operations.h"
 
+#include <cmath>
+
 #include "parser.h"
 
 BinOpr::BinOpr(const Register &_dst, Box<Value> &&_src) : dst(_dst), src(std::move(_src)) {
@@ -35,12 +37,87 @@ Box<Instruction> FloatingBinOpr::divf(AsmReader reader) {
         return FloatingBinOpr::factory(reader, [](double a, double b) { return a / b; });
 }
 
+Box<Instruction> FloatingBinOpr::pow(AsmReader reader) {
+        return FloatingBinOpr::factory(reader, [](double a, double b) { return std::pow(a, b); });
+}
+
+Box<Instruction> FloatingBinOpr::min(AsmReader reader) {
+        return FloatingBinOpr::factory(reader, [](double a, double b) { return std::fmin(a, b); });
+}
+
+Box<Instruction> FloatingBinOpr::max(AsmReader reader) {
+        return FloatingBinOpr::factory(reader, [](double a, double b) { return std::fmax(a, b); });
+}
+
 void FloatingBinOpr::execute(Vm &vm) const {
         const double result = operation(dst.getValue(vm), src->getValue(vm));
         vm.setRegister(dst, result);
         vm.goToNextInstruction();
 }
 
+Box<Instruction> FloatingUnOpr::factory(AsmReader reader, double (*const operation)(double)) {
+        const Register dst = reader.expectRegister();
+        Box<Value> src = reader.expectValue();
+        reader.expectEndOfArgs();
+        return new FloatingUnOpr(dst, std::move(src), operation);
+}
+
+FloatingUnOpr::FloatingUnOpr(const Register &_dst, Box<Value> &&_src,
+                             double (*const _operation)(double))
+    : dst(_dst), src(std::move(_src)), operation(_operation) {
+}
+
+Box<Instruction> FloatingUnOpr::sqrt(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::sqrt(x); });
+}
+
+Box<Instruction> FloatingUnOpr::sin(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::sin(x); });
+}
+
+Box<Instruction> FloatingUnOpr::cos(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::cos(x); });
+}
+
+Box<Instruction> FloatingUnOpr::exp(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::exp(x); });
+}
+
+Box<Instruction> FloatingUnOpr::log(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::log(x); });
+}
+
+Box<Instruction> FloatingUnOpr::abs(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::fabs(x); });
+}
+
+Box<Instruction> FloatingUnOpr::floor(AsmReader reader) {
+        return FloatingUnOpr::factory(reader, [](double x) { return std::floor(x); });
+}
+
+void FloatingUnOpr::execute(Vm &vm) const {
+        vm.setRegister(dst, operation(src->getValue(vm)));
+        vm.goToNextInstruction();
+}
+
+FusedMultiplyAdd::FusedMultiplyAdd(const Register &_dst, Box<Value> &&_lhs, Box<Value> &&_rhs)
+    : dst(_dst), lhs(std::move(_lhs)), rhs(std::move(_rhs)) {
+}
+
+Box<Instruction> FusedMultiplyAdd::factory(AsmReader reader) {
+        const Register dst = reader.expectRegister();
+        Box<Value> lhs = reader.expectValue();
+        Box<Value> rhs = reader.expectValue();
+        reader.expectEndOfArgs();
+        return new FusedMultiplyAdd(dst, std::move(lhs), std::move(rhs));
+}
+
+void FusedMultiplyAdd::execute(Vm &vm) const {
+        const double result = std::fma(lhs->getValue(vm), rhs->getValue(vm), dst.getValue(vm));
+        vm.setRegister(dst, result);
+        vm.goToNextInstruction();
+}
+
 Box<Instruction> IntegerBinOpr::factory(AsmReader reader,
                                         double (*const operation)(int64_t, int64_t)) {
         const Register dst = reader.expectRegister();
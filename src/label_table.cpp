@@ -0,0 +1,53 @@
+#include "label_table.h"
+
+Symbol LabelTable::intern(StringView label) {
+        const Symbol symbol = symbols.intern(label);
+        while (locations.length() <= symbol) {
+                locations.pushBack(NO_LOCATION);
+        }
+        return symbol;
+}
+
+bool LabelTable::declare(Symbol label, size_t location) {
+        if (locate(label).isSome()) {
+                return false;
+        }
+        define(label, location);
+        declared.pushBack(label);
+        return true;
+}
+
+void LabelTable::define(Symbol label, size_t location) {
+        locations[label].expect("Defining a label, which is not interned") = location;
+}
+
+void LabelTable::relocate(const Vector<size_t> &relocations) {
+        for (const Symbol label : declared) {
+                size_t &location = locations[label].unwrap();
+                location = relocations[location].unwrap();
+        }
+}
+
+Option<size_t> LabelTable::locate(Symbol label) const {
+        const Option<const size_t &> location = locations[label];
+        if (location.isNone() || location.unwrap() == NO_LOCATION) {
+                return Option<size_t>();
+        }
+        return Option<size_t>(location.unwrap());
+}
+
+Option<size_t> LabelTable::find(StringView label) const {
+        const Option<Symbol> symbol = symbols.find(label);
+        if (symbol.isNone()) {
+                return Option<size_t>();
+        }
+        return locate(symbol.unwrap());
+}
+
+const char *LabelTable::name(Symbol label) const {
+        return symbols.name(label);
+}
+
+const Vector<Symbol> &LabelTable::getDeclared() const {
+        return declared;
+}
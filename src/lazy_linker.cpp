@@ -0,0 +1,114 @@
+#include "lazy_linker.h"
+
+#include <cstring>
+
+#include "program.h"
+#include "vm.h"
+
+LinkStub::LinkStub(LazyLinker &_linker) : linker(_linker) {
+}
+
+void LinkStub::execute(Vm &vm) const {
+        // Linking replaces the stub itself, so it must not be accessed
+        // afterwards. Its memory stays in the arena of the program.
+        linker.link(vm.getNextInstruction());
+}
+
+LazyLinker::LazyLinker(String &&_source, Vector<size_t> &&_instructionOffsets,
+                       const Vector<size_t> &_regionStarts,
+                       const InstructionFactory &_instructionFactory,
+                       const HostFunctions &_hostFunctions)
+    : source(std::move(_source)),
+      instructionOffsets(std::move(_instructionOffsets)),
+      regionStarts(_regionStarts),
+      instructionFactory(_instructionFactory),
+      hostFunctions(_hostFunctions) {
+        for (size_t i = 0; i < regionStarts.length(); ++i) {
+                linkedRegions.pushBack(false);
+        }
+}
+
+void LazyLinker::attach(Program &_program) {
+        program = &_program;
+}
+
+Vector<Box<Instruction>> LazyLinker::createStubs() {
+        Vector<Box<Instruction>> stubs;
+        stubs.reserve(instructionOffsets.length());
+        for (size_t i = 0; i < instructionOffsets.length(); ++i) {
+                stubs.pushBack(Box<Instruction>(new LinkStub(*this)));
+        }
+        return stubs;
+}
+
+size_t LazyLinker::findRegion(size_t instructionIdx) const {
+        // The last region, which starts at or before the instruction.
+        size_t low = 0;
+        size_t high = regionStarts.length();
+        while (high - low > 1) {
+                const size_t mid = low + (high - low) / 2;
+                if (regionStarts[mid].unwrap() <= instructionIdx) {
+                        low = mid;
+                } else {
+                        high = mid;
+                }
+        }
+        return low;
+}
+
+String LazyLinker::instructionCode(size_t instructionIdx) const {
+        const char *start = source.cStr() + instructionOffsets[instructionIdx].unwrap();
+        const char *end = source.cStr() + source.length();
+        const char *lineEnd =
+            static_cast<const char *>(memchr(start, '\n', (size_t)(end - start)));
+        if (nullptr == lineEnd) {
+                lineEnd = end;
+        }
+        return Parser::extractCode(String(StringView(start, (size_t)(lineEnd - start))));
+}
+
+void LazyLinker::linkRegion(size_t region) {
+        const size_t start = regionStarts[region].unwrap();
+        const size_t end = region + 1 < regionStarts.length() ? regionStarts[region + 1].unwrap()
+                                                               : instructionOffsets.length();
+
+        // The region is linked aside and only then replaces the stubs, so a
+        // failure leaves the program unchanged.
+        Vector<Box<Instruction>> linked;
+        linked.reserve(end - start);
+        {
+                const Arena::Scope scope(arena);
+                for (size_t i = start; i < end; ++i) {
+                        const SourceLocation &location = program->sourceMap.getLocation(i);
+                        Context ctx(program->sourceMap.fileName(location.file));
+                        ctx.ln = location.line;
+                        ctx.column = location.column;
+                        const Parser::RawInstruction instr = Parser::tokenizeInstruction(
+                            instructionCode(i), ctx, instructionFactory, location);
+                        const InstructionFactory::Method factoryMethod =
+                            instructionFactory.getMethod(instr.mnemonic);
+                        linked.pushBack(factoryMethod(
+                            AsmReader(ctx, instr.args, program->labels, hostFunctions)));
+                }
+        }
+
+        for (size_t i = start; i < end; ++i) {
+                program->instructions[i].unwrap() = std::move(linked[i - start].unwrap());
+        }
+        linkedRegions[region].unwrap() = true;
+}
+
+void LazyLinker::link(size_t instructionIdx) {
+        const size_t region = findRegion(instructionIdx);
+        if (!linkedRegions[region].unwrap()) {
+                linkRegion(region);
+        }
+}
+
+void LazyLinker::linkAll() {
+        for (size_t region = 0; region < regionStarts.length(); ++region) {
+                if (!linkedRegions[region].unwrap()) {
+                        linkRegion(region);
+                }
+        }
+}
@@ -0,0 +1,49 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <stdexcept>
+
+MappedFile::MappedFile(const String &filename) {
+        static const String COULD_NOT_OPEN_FILE_MSG = "Could not open file: ";
+
+        const int fd = open(filename.cStr(), O_RDONLY);
+        if (fd < 0) {
+                const String msg = COULD_NOT_OPEN_FILE_MSG + filename;
+                throw std::runtime_error(msg.cStr());
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+                close(fd);
+                const String msg = COULD_NOT_OPEN_FILE_MSG + filename;
+                throw std::runtime_error(msg.cStr());
+        }
+
+        size = (size_t)info.st_size;
+        // An empty file cannot be mapped, but it has no contents to view.
+        if (size > 0) {
+                void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (MAP_FAILED == mapping) {
+                        close(fd);
+                        const String msg = String("Could not map file: ") + filename;
+                        throw std::runtime_error(msg.cStr());
+                }
+                data = static_cast<const char *>(mapping);
+                // The source is read front to back by each parsing thread.
+                (void)madvise(mapping, size, MADV_SEQUENTIAL);
+        }
+        close(fd);
+}
+
+MappedFile::~MappedFile() {
+        if (data != nullptr) {
+                munmap(const_cast<char *>(data), size);
+        }
+}
+
+StringView MappedFile::contents() const {
+        return StringView(data == nullptr ? "" : data, size);
+}
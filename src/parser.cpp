@@ -1,7 +1,18 @@
 
 #include "parser.h"
 
-InstructionFactory::Map InstructionFactory::GLOBAL_INSTRUCTION_FACTORY;
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "lazy_linker.h"
+#include "mapped_file.h"
+
+InstructionFactory InstructionFactory::GLOBAL_INSTRUCTION_FACTORY;
 
 String AsmReader::expectArg() {
         if (readPos >= args.length()) {
@@ -10,9 +21,14 @@ String AsmReader::expectArg() {
         return args[readPos++].unwrap();
 }
 
-AsmReader::AsmReader(const Context &_ctx, const Vector<String> &_args,
-                     const HashMap<String, size_t> &_labels)
-    : ctx(_ctx), args(_args), labels(_labels) {
+AsmReader::AsmReader(const Context &_ctx, const InstructionArgs &_args, const LabelTable &_labels,
+                     const HostFunctions &_hostFunctions, Symbol _target, Symbol *_deferredLabel)
+    : ctx(_ctx),
+      args(_args),
+      labels(_labels),
+      hostFunctions(_hostFunctions),
+      target(_target),
+      deferredLabel(_deferredLabel) {
 }
 
 Register AsmReader::expectRegister() {
@@ -39,6 +55,9 @@ Literal AsmReader::expectLiteral() {
 }
 
 Box<Value> AsmReader::expectValue() {
+        if (readPos >= args.length()) {
+                throw ExpectedArgumentException(ctx);
+        }
         const String str = args[readPos].unwrap();
         if (str.startsWith('r')) {
                 return Box<Value>(new Register(expectRegister()));
@@ -49,21 +68,61 @@ Box<Value> AsmReader::expectValue() {
 
 size_t AsmReader::expectLabelLocation() {
         const String label = expectArg();
-        const Option<size_t> location = labels.get(label);
+        const Option<size_t> location =
+            target != SymbolTable::NO_SYMBOL ? labels.locate(target) : labels.find(label);
         if (location.isNone()) {
+                if (deferredLabel != nullptr && target != SymbolTable::NO_SYMBOL) {
+                        *deferredLabel = target;
+                        return LabelTable::NO_LOCATION;
+                }
                 throw UnknownLabelException(ctx, label);
         }
         return location.unwrap();
 }
 
+HostFunction AsmReader::expectHostFunction() {
+        const String name = expectArg();
+        const Option<HostFunction> function = hostFunctions.find(name);
+        if (function.isNone()) {
+                throw UnknownHostFunctionException(ctx, name);
+        }
+        return function.unwrap();
+}
+
 void AsmReader::expectEndOfArgs() {
         if (readPos < args.length()) {
                 throw UnexpectedArgumentsException(ctx);
         }
 }
 
-const InstructionFactory::Map &InstructionFactory::getGlobalInstructionFactory() {
-        if (GLOBAL_INSTRUCTION_FACTORY.isEmpty()) {
+void InstructionFactory::insert(const char *mnemonic, Method method) {
+        const Symbol symbol = mnemonics.intern(mnemonic);
+        methods.pushBack(method);
+        if (symbol + 1 != methods.length()) {
+                throw std::logic_error("Duplicate mnemonic in the instruction factory");
+        }
+}
+
+Option<Symbol> InstructionFactory::find(StringView mnemonic) const {
+        return mnemonics.find(mnemonic);
+}
+
+Symbol InstructionFactory::expect(const char *mnemonic) const {
+        return mnemonics.find(mnemonic).expect("Unknown built-in mnemonic");
+}
+
+InstructionFactory::Method InstructionFactory::getMethod(Symbol mnemonic) const {
+        return methods[mnemonic].unwrap();
+}
+
+const char *InstructionFactory::getMnemonic(Symbol mnemonic) const {
+        return mnemonics.name(mnemonic);
+}
+
+const InstructionFactory &InstructionFactory::getGlobalInstructionFactory() {
+        // The parsers of the parallel mode are created on multiple threads.
+        static std::once_flag initialized;
+        std::call_once(initialized, []() {
                 GLOBAL_INSTRUCTION_FACTORY.insert("mov", Mov::factory);
 
                 GLOBAL_INSTRUCTION_FACTORY.insert("ifeq", IfStmt::ifeq);
@@ -76,12 +135,25 @@ const InstructionFactory::Map &InstructionFactory::getGlobalInstructionFactory()
                 GLOBAL_INSTRUCTION_FACTORY.insert("jmp", Jmp::factory);
                 GLOBAL_INSTRUCTION_FACTORY.insert("call", Call::factory);
                 GLOBAL_INSTRUCTION_FACTORY.insert("return", Return::factory);
+                GLOBAL_INSTRUCTION_FACTORY.insert("ncall", NativeCall::factory);
 
                 GLOBAL_INSTRUCTION_FACTORY.insert("addf", FloatingBinOpr::addf);
                 GLOBAL_INSTRUCTION_FACTORY.insert("subf", FloatingBinOpr::subf);
                 GLOBAL_INSTRUCTION_FACTORY.insert("mulf", FloatingBinOpr::mulf);
                 GLOBAL_INSTRUCTION_FACTORY.insert("divf", FloatingBinOpr::divf);
 
+                GLOBAL_INSTRUCTION_FACTORY.insert("pow", FloatingBinOpr::pow);
+                GLOBAL_INSTRUCTION_FACTORY.insert("min", FloatingBinOpr::min);
+                GLOBAL_INSTRUCTION_FACTORY.insert("max", FloatingBinOpr::max);
+                GLOBAL_INSTRUCTION_FACTORY.insert("sqrt", FloatingUnOpr::sqrt);
+                GLOBAL_INSTRUCTION_FACTORY.insert("sin", FloatingUnOpr::sin);
+                GLOBAL_INSTRUCTION_FACTORY.insert("cos", FloatingUnOpr::cos);
+                GLOBAL_INSTRUCTION_FACTORY.insert("exp", FloatingUnOpr::exp);
+                GLOBAL_INSTRUCTION_FACTORY.insert("log", FloatingUnOpr::log);
+                GLOBAL_INSTRUCTION_FACTORY.insert("abs", FloatingUnOpr::abs);
+                GLOBAL_INSTRUCTION_FACTORY.insert("floor", FloatingUnOpr::floor);
+                GLOBAL_INSTRUCTION_FACTORY.insert("fma", FusedMultiplyAdd::factory);
+
                 GLOBAL_INSTRUCTION_FACTORY.insert("add", IntegerBinOpr::add);
                 GLOBAL_INSTRUCTION_FACTORY.insert("sub", IntegerBinOpr::sub);
                 GLOBAL_INSTRUCTION_FACTORY.insert("mul", IntegerBinOpr::mul);
@@ -95,37 +167,139 @@ const InstructionFactory::Map &InstructionFactory::getGlobalInstructionFactory()
                 GLOBAL_INSTRUCTION_FACTORY.insert("pop", Pop::factory);
 
                 GLOBAL_INSTRUCTION_FACTORY.insert("print", Print::factory);
-        }
+        });
         return GLOBAL_INSTRUCTION_FACTORY;
 }
 
-Parser::Parser() : instructionFactory(InstructionFactory::getGlobalInstructionFactory()) {
+Parser::Parser() : Parser(HostFunctions::getGlobal()) {
+}
+
+Parser::Parser(const HostFunctions &_hostFunctions)
+    : instructionFactory(InstructionFactory::getGlobalInstructionFactory()),
+      hostFunctions(_hostFunctions),
+      jmpMnemonic(instructionFactory.expect("jmp")),
+      callMnemonic(instructionFactory.expect("call")),
+      returnMnemonic(instructionFactory.expect("return")),
+      pushMnemonic(instructionFactory.expect("push")),
+      popMnemonic(instructionFactory.expect("pop")),
+      ncallMnemonic(instructionFactory.expect("ncall")) {
 }
 
-void Parser::parseLabel(const String &line, const Context &ctx, size_t currentInstructionIdx) {
-        const String label = line.substr(0, line.length() - 1);
+/// The 1-based column of the first character of code on the line, or 0 for a
+/// blank line.
+static size_t codeColumn(const String &line) {
+        const char *str = line.cStr();
+        for (size_t i = 0; i < line.length(); ++i) {
+                if (!isWhitespace(str[i])) {
+                        return i + 1;
+                }
+        }
+        return 0;
+}
+
+/// Strips the comment and the surrounding whitespace of a line of the source
+/// and advances the context to it.
+static String prepareCodeLine(String line, Context &ctx) {
+        ctx.ln += 1;
+        ctx.column = codeColumn(line);
+        return Parser::extractCode(line);
+}
+
+/// Reads the next line of the source, without its comment and the surrounding
+/// whitespace, and advances the context to it.
+static String readCodeLine(std::istream &sourceCode, Context &ctx) {
+        return prepareCodeLine(String::readLine(sourceCode), ctx);
+}
+
+/// Reads the next line of the source in memory, moving the cursor past it.
+static String readCodeLine(const char *&cursor, const char *end, Context &ctx) {
+        const char *lineEnd =
+            static_cast<const char *>(memchr(cursor, '\n', (size_t)(end - cursor)));
+        if (nullptr == lineEnd) {
+                lineEnd = end;
+        }
+        String line(StringView(cursor, (size_t)(lineEnd - cursor)));
+        cursor = lineEnd == end ? end : lineEnd + 1;
+        return prepareCodeLine(std::move(line), ctx);
+}
+
+String Parser::extractCode(const String &line) {
+        String code = line.trim();
+        code.truncateAfter(';');  // Remove comments
+        return code;
+}
+
+Context Parser::beginSource(const String &name) {
+        const Symbol file = files.intern(name);
+        if (file > UINT16_MAX) {
+                throw std::runtime_error("Too many source files in a single parser");
+        }
+        currentFile = (uint16_t)file;
+        return Context(files.name(currentFile));
+}
+
+Context Parser::locationContext(const SourceLocation &location) const {
+        Context ctx(files.name(location.file));
+        ctx.ln = location.line;
+        ctx.column = location.column;
+        return ctx;
+}
+
+String Parser::parseLabelName(const String &line, const Context &ctx) {
+        String label = line.substr(0, line.length() - 1);
         if (!label.all(isIdentifier)) {
                 throw InvalidLabelException(ctx, label);
         }
-        if (labels.contains(label)) {
+        return label;
+}
+
+Symbol Parser::parseLabel(const String &line, const Context &ctx, size_t currentInstructionIdx) {
+        const String label = parseLabelName(line, ctx);
+        const Symbol symbol = labels.intern(label);
+        if (!labels.declare(symbol, currentInstructionIdx)) {
                 throw ConflictingLabelException(ctx, label);
         }
-        labels.insert(label, currentInstructionIdx);
+        return symbol;
+}
+
+Parser::RawInstruction Parser::tokenizeInstruction(const String &line, const Context &ctx,
+                                                   const InstructionFactory &instructionFactory,
+                                                   const SourceLocation &location) {
+        SmallVector<String, MAX_INSTRUCTION_ARGS + 1> tokens;
+        line.splitInto(' ', tokens);
+        const String &instruction = tokens[0].expect("Parsing an empty instruction");
+        const Option<Symbol> mnemonic = instructionFactory.find(instruction);
+        if (mnemonic.isNone()) {
+                throw UnknownInstructionException(ctx, instruction);
+        }
+
+        InstructionArgs args;
+        for (size_t i = 1; i < tokens.length(); ++i) {
+                args.pushBack(std::move(tokens[i].unwrap()));
+        }
+        return RawInstruction{mnemonic.unwrap(), std::move(args), location};
+}
+
+SourceLocation Parser::currentLocation(const Context &ctx) const {
+        return SourceLocation{currentFile, (uint16_t)std::min(ctx.column, (size_t)UINT16_MAX),
+                              (uint32_t)ctx.ln};
 }
 
 Parser::RawInstruction Parser::parseInstruction(const String &line, const Context &ctx) {
-        Vector<String> args = line.split(' ');
-        const String instruction = args.popFront().expect("Parsing an empty instruction");
-        return {instruction, std::move(args), ctx};
+        RawInstruction result =
+            tokenizeInstruction(line, ctx, instructionFactory, currentLocation(ctx));
+        const bool referencesLabel =
+            result.mnemonic == jmpMnemonic || result.mnemonic == callMnemonic;
+        if (referencesLabel && result.args.length() == 1) {
+                result.target = labels.intern(result.args[0].unwrap());
+        }
+        return result;
 }
 
 Vector<Parser::RawInstruction> Parser::parseFileContents(std::istream &sourceCode, Context &ctx) {
         Vector<RawInstruction> rawInstructions;
         do {
-                String line = String::readLine(sourceCode).trim();
-                ctx.ln += 1;
-
-                line.truncateAfter(';');  // Remove comments
+                const String line = readCodeLine(sourceCode, ctx);
                 if (line.isEmpty()) {
                         continue;
                 }
@@ -140,21 +314,328 @@ Vector<Parser::RawInstruction> Parser::parseFileContents(std::istream &sourceCod
         return rawInstructions;
 }
 
-Vector<Box<Instruction>> Parser::linkInstructions(const Vector<RawInstruction> &rawInstructions) {
+bool Parser::isConditional(Symbol mnemonic) const {
+        return 0 == strncmp(instructionFactory.getMnemonic(mnemonic), "if", 2);
+}
+
+bool Parser::isGuarded(const Vector<RawInstruction> &rawInstructions, size_t idx) const {
+        return idx > 0 && isConditional(rawInstructions[idx - 1].unwrap().mnemonic);
+}
+
+Option<size_t> Parser::findInlineBody(const Vector<RawInstruction> &rawInstructions,
+                                      Symbol label) const {
+        const Option<size_t> location = labels.locate(label);
+        if (location.isNone()) {
+                return Option<size_t>();
+        }
+
+        const size_t start = location.unwrap();
+        size_t furthestJump = start;
+        for (size_t i = start; i < rawInstructions.length() && i - start <= INLINE_BUDGET; ++i) {
+                const RawInstruction &instr = rawInstructions[i].unwrap();
+                if (instr.mnemonic == returnMnemonic) {
+                        if (isGuarded(rawInstructions, i)) {
+                                continue;
+                        }
+                        if (furthestJump > i) {
+                                return Option<size_t>();
+                        }
+                        return Option<size_t>(i);
+                }
+                if (instr.mnemonic == pushMnemonic || instr.mnemonic == popMnemonic ||
+                    instr.mnemonic == ncallMnemonic) {
+                        return Option<size_t>();
+                }
+
+                const bool isJmp = instr.mnemonic == jmpMnemonic;
+                if (!isJmp && instr.mnemonic != callMnemonic) {
+                        continue;
+                }
+                if (instr.target == SymbolTable::NO_SYMBOL) {
+                        return Option<size_t>();
+                }
+                if (!isJmp) {
+                        if (instr.target == label) {
+                                return Option<size_t>();
+                        }
+                        continue;
+                }
+                const Option<size_t> targetLocation = labels.locate(instr.target);
+                if (targetLocation.isNone() || targetLocation.unwrap() < start) {
+                        return Option<size_t>();
+                }
+                furthestJump = std::max(furthestJump, targetLocation.unwrap());
+        }
+        return Option<size_t>();
+}
+
+void Parser::inlineBody(const Vector<RawInstruction> &rawInstructions, size_t start, size_t end,
+                        size_t inlineId, Vector<RawInstruction> &result) {
+        // The `@` symbol is not a valid identifier character, so the generated
+        // labels can never clash with the ones declared by the user. They are
+        // defined directly at their locations after inlining, while the user
+        // labels are relocated once all calls are inlined.
+        const String suffix = String("@") + String::fromNumber(inlineId);
+        const Symbol exit = labels.intern(suffix);
+        const size_t base = result.length();
+
+        const auto jumpToExit = [this, &suffix, exit](const SourceLocation &location) {
+                InstructionArgs args;
+                args.pushBack(suffix);
+                return RawInstruction{jmpMnemonic, std::move(args), location, exit};
+        };
+
+        for (size_t i = start; i < end; ++i) {
+                RawInstruction instr = rawInstructions[i].unwrap();
+                if (instr.mnemonic == returnMnemonic) {
+                        result.pushBack(jumpToExit(instr.location));
+                        continue;
+                }
+                if (instr.mnemonic == jmpMnemonic) {
+                        const size_t location = labels.locate(instr.target).unwrap();
+                        String &target = instr.args[0].unwrap();
+                        target = target + suffix;
+                        instr.target = labels.intern(target);
+                        if (labels.locate(instr.target).isNone()) {
+                                labels.define(instr.target, base + (location - start));
+                        }
+                }
+                result.pushBack(std::move(instr));
+        }
+        labels.define(exit, result.length());
+}
+
+Vector<Parser::RawInstruction> Parser::inlineCalls(const Vector<RawInstruction> &rawInstructions) {
+        Vector<RawInstruction> result;
+        // Maps the index of each raw instruction to its index after inlining.
+        Vector<size_t> relocations;
+        size_t inlineCount = 0;
+
+        for (size_t i = 0; i < rawInstructions.length(); ++i) {
+                relocations.pushBack(result.length());
+                const RawInstruction &instr = rawInstructions[i].unwrap();
+
+                // Expanding a guarded call would leave only the first
+                // instruction of the body under the `if` statement.
+                Option<size_t> bodyEnd;
+                if (instr.mnemonic == callMnemonic && instr.target != SymbolTable::NO_SYMBOL &&
+                    !isGuarded(rawInstructions, i)) {
+                        bodyEnd = findInlineBody(rawInstructions, instr.target);
+                }
+
+                if (bodyEnd.isNone()) {
+                        result.pushBack(RawInstruction(instr));
+                        continue;
+                }
+                const size_t start = labels.locate(instr.target).unwrap();
+                inlineBody(rawInstructions, start, bodyEnd.unwrap(), ++inlineCount, result);
+        }
+        relocations.pushBack(result.length());
+
+        if (inlineCount > 0) {
+                labels.relocate(relocations);
+        }
+        return result;
+}
+
+Vector<Box<Instruction>> Parser::linkInstructions(const Vector<RawInstruction> &rawInstructions,
+                                                  Context &ctx) {
         Vector<Box<Instruction>> instructions;
+        instructions.reserve(rawInstructions.length());
         for (const RawInstruction &instr : rawInstructions) {
-                const String &name = instr.name;
-                Option<InstructionFactory::Method> factoryMethod = instructionFactory.get(name);
-                if (factoryMethod.isNone()) {
-                        throw UnknownInstructionException(instr.ctx, name);
+                instructions.pushBack(linkInstruction(instr, ctx));
+        }
+
+        return instructions;
+}
+
+Box<Instruction> Parser::linkInstruction(const RawInstruction &instr, Context &ctx,
+                                         Symbol *deferredLabel) {
+        const InstructionFactory::Method factoryMethod = instructionFactory.getMethod(instr.mnemonic);
+        ctx = locationContext(instr.location);
+        Box<Instruction> result = factoryMethod(
+            AsmReader(ctx, instr.args, labels, hostFunctions, instr.target, deferredLabel));
+        sourceLocations.pushBack(instr.location);
+        return result;
+}
+
+Vector<Box<Instruction>> Parser::parseSinglePass(std::istream &sourceCode, Context &ctx) {
+        // A previous parse might have failed before checking its fixups.
+        fixups.clear();
+        firstFixup.clear();
+
+        Vector<Box<Instruction>> instructions;
+        do {
+                const String line = readCodeLine(sourceCode, ctx);
+                if (line.isEmpty()) {
+                        continue;
+                }
+
+                if (line.endsWith(':')) {
+                        const Symbol label = parseLabel(line, ctx, instructions.length());
+                        resolveFixups(label, instructions.length(), instructions);
+                        continue;
+                }
+
+                const RawInstruction instr = parseInstruction(line, ctx);
+                Symbol deferredLabel = SymbolTable::NO_SYMBOL;
+                instructions.pushBack(linkInstruction(instr, ctx, &deferredLabel));
+                if (deferredLabel != SymbolTable::NO_SYMBOL) {
+                        addFixup(instructions.length() - 1, deferredLabel, instr.location);
                 }
-                instructions.pushBack(
-                    factoryMethod.unwrap()(AsmReader(instr.ctx, instr.args, labels)));
+        } while (!sourceCode.eof());
+
+        checkFixups();
+        fixups.clear();
+        firstFixup.clear();
+        return instructions;
+}
+
+void Parser::addFixup(size_t instructionIdx, Symbol label, const SourceLocation &location) {
+        while (firstFixup.length() <= label) {
+                firstFixup.pushBack(size_t(NO_FIXUP));
+        }
+        size_t &first = firstFixup[label].unwrap();
+        fixups.pushBack(Fixup{instructionIdx, label, location, first});
+        first = fixups.length() - 1;
+}
+
+void Parser::resolveFixups(Symbol label, size_t location, Vector<Box<Instruction>> &instructions) {
+        if (label >= firstFixup.length()) {
+                return;
         }
+        size_t &first = firstFixup[label].unwrap();
+        for (size_t idx = first; idx != NO_FIXUP;) {
+                Fixup &fixup = fixups[idx].unwrap();
+                instructions[fixup.instructionIdx].unwrap()->patchLabelLocation(location);
+                fixup.label = SymbolTable::NO_SYMBOL;
+                idx = fixup.next;
+        }
+        first = NO_FIXUP;
+}
+
+Vector<std::pair<StringView, size_t>> Parser::splitIntoChunks(StringView source) const {
+        const size_t length = source.length();
+        const size_t chunkCount =
+            std::clamp(length / MIN_CHUNK_SIZE, (size_t)1, threads * CHUNKS_PER_THREAD);
+        const size_t targetSize = length / chunkCount;
+
+        Vector<std::pair<StringView, size_t>> result(chunkCount);
+        const char *start = source.data();
+        const char *end = source.data() + length;
+        size_t firstLine = 1;
+        while (start < end || result.length() == 0) {
+                const char *chunkEnd = end;
+                if (result.length() + 1 < chunkCount && (size_t)(end - start) > targetSize) {
+                        // Each chunk ends right after a line break, so no line
+                        // is split between two chunks.
+                        const char *lineBreak = static_cast<const char *>(
+                            memchr(start + targetSize, '\n', (size_t)(end - start) - targetSize));
+                        chunkEnd = nullptr == lineBreak ? end : lineBreak + 1;
+                }
+                result.pushBack({StringView(start, (size_t)(chunkEnd - start)), firstLine});
+                firstLine += (size_t)std::count(start, chunkEnd, '\n');
+                start = chunkEnd;
+        }
+        return result;
+}
+
+void Parser::parseChunk(StringView source, const String &name, size_t firstLine,
+                        ParsedChunk &result) {
+        const Arena::Scope scope(result.arena);
+        Context ctx = beginSource(name);
+        ctx.ln = firstLine - 1;
+
+        const char *cursor = source.data();
+        const char *end = source.data() + source.length();
+        while (cursor < end) {
+                const String line = readCodeLine(cursor, end, ctx);
+                if (line.isEmpty()) {
+                        continue;
+                }
+
+                // The labels are only declared once the chunks are merged, so
+                // every label reference of the chunk is deferred.
+                if (line.endsWith(':')) {
+                        const Symbol label = labels.intern(parseLabelName(line, ctx));
+                        const SourceLocation location{
+                            currentFile, (uint16_t)std::min(ctx.column, (size_t)UINT16_MAX),
+                            (uint32_t)ctx.ln};
+                        result.declarations.pushBack(
+                            LabelDeclaration{label, result.instructions.length(), location});
+                        continue;
+                }
 
+                const RawInstruction instr = parseInstruction(line, ctx);
+                Symbol deferredLabel = SymbolTable::NO_SYMBOL;
+                result.instructions.pushBack(linkInstruction(instr, ctx, &deferredLabel));
+                if (deferredLabel != SymbolTable::NO_SYMBOL) {
+                        result.fixups.pushBack(Fixup{result.instructions.length() - 1,
+                                                     deferredLabel, instr.location, NO_FIXUP});
+                }
+        }
+        result.locations = std::move(sourceLocations);
+        result.labels = std::move(labels);
+}
+
+Vector<Box<Instruction>> Parser::mergeChunks(Vector<ParsedChunk> &chunks, Arena &arena) {
+        // The locations of the chunks refer to the files of their workers,
+        // which only parsed this source.
+        const auto relocate = [this](SourceLocation location) {
+                location.file = currentFile;
+                return location;
+        };
+
+        // The labels are declared first, since a reference may point to any
+        // chunk.
+        size_t offset = 0;
+        for (const ParsedChunk &chunk : chunks) {
+                for (const LabelDeclaration &declaration : chunk.declarations) {
+                        const char *name = chunk.labels.name(declaration.label);
+                        if (!labels.declare(labels.intern(name), offset + declaration.instructionIdx)) {
+                                throw ConflictingLabelException(
+                                    locationContext(relocate(declaration.location)), String(name));
+                        }
+                }
+                offset += chunk.instructions.length();
+        }
+
+        Vector<Box<Instruction>> instructions(offset);
+        for (ParsedChunk &chunk : chunks) {
+                for (const Fixup &fixup : chunk.fixups) {
+                        const char *name = chunk.labels.name(fixup.label);
+                        const Option<size_t> location = labels.find(name);
+                        if (location.isNone()) {
+                                throw UnknownLabelException(
+                                    locationContext(relocate(fixup.location)), String(name));
+                        }
+                        chunk.instructions[fixup.instructionIdx].unwrap()->patchLabelLocation(
+                            location.unwrap());
+                }
+                for (Box<Instruction> &instruction : chunk.instructions) {
+                        instructions.pushBack(std::move(instruction));
+                }
+                for (const SourceLocation &location : chunk.locations) {
+                        sourceLocations.pushBack(relocate(location));
+                }
+                chunk.instructions.clear();
+                arena.adopt(std::move(chunk.arena));
+        }
         return instructions;
 }
 
+void Parser::checkFixups() {
+        // The fixups are recorded in source order, so the first unresolved one
+        // is the error, which the two pass parser would report.
+        for (const Fixup &fixup : fixups) {
+                if (fixup.label == SymbolTable::NO_SYMBOL) {
+                        continue;
+                }
+                throw UnknownLabelException(locationContext(fixup.location),
+                                            String(labels.name(fixup.label)));
+        }
+}
+
 Vector<Box<Instruction>> Parser::parseFile(const String &filename) {
         static const String COULD_NOT_OPEN_FILE_MSG = "Could not open file: ";
 
@@ -164,13 +645,201 @@ Vector<Box<Instruction>> Parser::parseFile(const String &filename) {
                 throw std::runtime_error(msg.cStr());
         }
 
-        Context ctx(filename);
-        Vector<RawInstruction> rawInstructions = parseFileContents(sourceCode, ctx);
-        sourceCode.close();
+        return parse(sourceCode, filename);
+}
+
+Vector<Box<Instruction>> Parser::parse(std::istream &sourceCode, const String &name) {
+        Context ctx = beginSource(name);
+        if (singlePass) {
+                return parseSinglePass(sourceCode, ctx);
+        }
+        const Vector<RawInstruction> rawInstructions = parseFileContents(sourceCode, ctx);
+        if (inlining) {
+                return linkInstructions(inlineCalls(rawInstructions), ctx);
+        }
+        return linkInstructions(rawInstructions, ctx);
+}
+
+Program Parser::compile(std::istream &sourceCode, const String &name) {
+        if (lazyLinking) {
+                return compileLazy(sourceCode, name);
+        }
+        // The arena is declared first, so that it outlives the instructions
+        // placed in it, even if the parsing fails.
+        Arena arena;
+        Vector<Box<Instruction>> instructions;
+        {
+                const Arena::Scope scope(arena);
+                instructions = parse(sourceCode, name);
+        }
+        return takeProgram(name, std::move(arena), std::move(instructions),
+                           Option<Box<LazyLinker>>());
+}
+
+Vector<size_t> Parser::findRegionStarts(size_t instructionCount) const {
+        Vector<bool> isStart(instructionCount);
+        for (size_t i = 0; i < instructionCount; ++i) {
+                isStart.pushBack(i == 0);
+        }
+        for (const Symbol label : labels.getDeclared()) {
+                const size_t location = labels.locate(label).unwrap();
+                if (location < instructionCount) {
+                        isStart[location].unwrap() = true;
+                }
+        }
 
-        return linkInstructions(rawInstructions);
+        Vector<size_t> starts;
+        for (size_t i = 0; i < instructionCount; ++i) {
+                if (isStart[i].unwrap()) {
+                        starts.pushBack(i);
+                }
+        }
+        return starts;
 }
 
-const HashMap<String, size_t> &Parser::getLabels() const {
+Vector<size_t> Parser::indexSource(StringView source, Context &ctx) {
+        Vector<size_t> instructionOffsets;
+        const char *cursor = source.data();
+        const char *end = cursor + source.length();
+        while (cursor < end) {
+                const size_t offset = (size_t)(cursor - source.data());
+                const String line = readCodeLine(cursor, end, ctx);
+                if (line.isEmpty()) {
+                        continue;
+                }
+
+                if (line.endsWith(':')) {
+                        parseLabel(line, ctx, instructionOffsets.length());
+
+                } else {
+                        instructionOffsets.pushBack(offset);
+                        sourceLocations.pushBack(currentLocation(ctx));
+                }
+        }
+        return instructionOffsets;
+}
+
+Program Parser::compileLazy(std::istream &sourceCode, const String &name) {
+        Context ctx = beginSource(name);
+        const std::string text((std::istreambuf_iterator<char>(sourceCode)),
+                               std::istreambuf_iterator<char>());
+        String source(StringView(text.data(), text.size()));
+        Vector<size_t> instructionOffsets = indexSource(source, ctx);
+        const Vector<size_t> regionStarts = findRegionStarts(instructionOffsets.length());
+
+        Arena arena;
+        Box<LazyLinker> linker(new LazyLinker(std::move(source), std::move(instructionOffsets),
+                                              regionStarts, instructionFactory, hostFunctions));
+        Vector<Box<Instruction>> stubs;
+        {
+                const Arena::Scope scope(arena);
+                stubs = linker->createStubs();
+        }
+        return takeProgram(name, std::move(arena), std::move(stubs),
+                           Option<Box<LazyLinker>>(std::move(linker)));
+}
+
+Program Parser::takeProgram(const String &name, Arena &&arena,
+                            Vector<Box<Instruction>> &&instructions,
+                            Option<Box<LazyLinker>> &&linker) {
+        SourceMap sourceMap(*this);
+        LabelTable programLabels = std::move(labels);
+
+        labels = LabelTable();
+        files = SymbolTable();
+        sourceLocations = Vector<SourceLocation>();
+        return Program(name, std::move(arena), std::move(instructions), std::move(programLabels),
+                       std::move(sourceMap), std::move(linker));
+}
+
+Program Parser::compileFile(const String &filename) {
+        if (threads <= 1) {
+                static const String COULD_NOT_OPEN_FILE_MSG = "Could not open file: ";
+
+                std::ifstream sourceCode(filename.cStr());
+                if (!sourceCode.is_open()) {
+                        const String msg = COULD_NOT_OPEN_FILE_MSG + filename;
+                        throw std::runtime_error(msg.cStr());
+                }
+                return compile(sourceCode, filename);
+        }
+        const MappedFile file(filename);
+        return compileParallel(file.contents(), filename);
+}
+
+Program Parser::compileParallel(StringView source, const String &name) {
+        Vector<std::pair<StringView, size_t>> pieces = splitIntoChunks(source);
+        Vector<ParsedChunk> chunks(pieces.length());
+        for (size_t i = 0; i < pieces.length(); ++i) {
+                chunks.emplaceBack();
+        }
+
+        // The workers take the chunks in order from a shared counter, until
+        // none are left.
+        std::atomic<size_t> nextChunk = 0;
+        // Each chunk is parsed by a parser of its own, so the workers share
+        // nothing but the read-only instruction factory and host functions.
+        const auto work = [this, &pieces, &chunks, &nextChunk, &name]() {
+                for (size_t idx = nextChunk++; idx < chunks.length(); idx = nextChunk++) {
+                        const std::pair<StringView, size_t> &piece = pieces[idx].unwrap();
+                        ParsedChunk &chunk = chunks[idx].unwrap();
+                        try {
+                                Parser worker(hostFunctions);
+                                worker.parseChunk(piece.first, name, piece.second, chunk);
+                        } catch (...) {
+                                chunk.error = std::current_exception();
+                        }
+                }
+        };
+        const size_t workerCount = std::min(threads, chunks.length());
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < workerCount; ++i) {
+                workers.emplace_back(work);
+        }
+        work();
+        for (std::thread &worker : workers) {
+                worker.join();
+        }
+
+        // The errors are reported in source order, as the sequential parser
+        // would report the first one.
+        for (const ParsedChunk &chunk : chunks) {
+                if (chunk.error) {
+                        std::rethrow_exception(chunk.error);
+                }
+        }
+
+        beginSource(name);
+        Arena arena;
+        Vector<Box<Instruction>> instructions = mergeChunks(chunks, arena);
+        return takeProgram(name, std::move(arena), std::move(instructions),
+                           Option<Box<LazyLinker>>());
+}
+
+void Parser::setThreads(size_t count) {
+        threads = std::max(count, (size_t)1);
+}
+
+void Parser::setInlining(bool enabled) {
+        inlining = enabled;
+}
+
+void Parser::setSinglePass(bool enabled) {
+        singlePass = enabled;
+}
+
+void Parser::setLazyLinking(bool enabled) {
+        lazyLinking = enabled;
+}
+
+const LabelTable &Parser::getLabels() const {
         return labels;
 }
+
+const Vector<SourceLocation> &Parser::getSourceLocations() const {
+        return sourceLocations;
+}
+
+const SymbolTable &Parser::getFiles() const {
+        return files;
+}
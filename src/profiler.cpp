@@ -0,0 +1,186 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+Profiler::Profiler(const Vector<Box<Instruction>> &instructions, const SourceMap &_sourceMap,
+                   size_t entry)
+    : sourceMap(_sourceMap) {
+        for (size_t i = 0; i < instructions.length(); ++i) {
+                kinds.pushBack(classifyInstruction(*instructions[i].unwrap()));
+                counters.pushBack(Counter());
+        }
+
+        Frame root;
+        if (entry < instructions.length()) {
+                root.label = sourceMap.getEnclosingLabel(entry);
+        }
+        frames.pushBack(std::move(root));
+}
+
+void Profiler::enter(size_t location) {
+        size_t label = SourceMap::NO_LABEL;
+        if (location < sourceMap.instructionCount()) {
+                label = sourceMap.getLabelAt(location);
+                if (label == SourceMap::NO_LABEL) {
+                        label = sourceMap.getEnclosingLabel(location);
+                }
+        }
+
+        size_t child = frames[currentFrame].unwrap().firstChild;
+        while (child != NO_FRAME) {
+                const Frame &frame = frames[child].unwrap();
+                if (frame.label == label) {
+                        currentFrame = child;
+                        return;
+                }
+                child = frame.nextSibling;
+        }
+
+        Frame frame;
+        frame.parent = currentFrame;
+        frame.label = label;
+        frame.nextSibling = frames[currentFrame].unwrap().firstChild;
+        const size_t frameIdx = frames.length();
+        frames.pushBack(std::move(frame));
+        frames[currentFrame].unwrap().firstChild = frameIdx;
+        currentFrame = frameIdx;
+}
+
+void Profiler::leave() {
+        const size_t parent = frames[currentFrame].unwrap().parent;
+        if (parent != NO_FRAME) {
+                currentFrame = parent;
+        }
+}
+
+void Profiler::record(size_t instructionIdx, size_t next, Ticks ticks) {
+        Counter &counter = counters[instructionIdx].unwrap();
+        counter.executions += 1;
+        counter.ticks += ticks;
+        frames[currentFrame].unwrap().ticks += ticks;
+
+        switch (kinds[instructionIdx].unwrap()) {
+                case InstructionKind::Call:
+                        enter(next);
+                        break;
+                case InstructionKind::Return:
+                        leave();
+                        break;
+                case InstructionKind::Branch:
+                case InstructionKind::Other:
+                        break;
+        }
+}
+
+String Profiler::framePath(size_t frameIdx) const {
+        Vector<size_t> path;
+        while (frameIdx != NO_FRAME) {
+                path.pushBack(size_t(frameIdx));
+                frameIdx = frames[frameIdx].unwrap().parent;
+        }
+
+        String result;
+        while (path.length() > 0) {
+                const size_t frame = path.popBack().unwrap();
+                result.append(sourceMap.labelName(frames[frame].unwrap().label));
+                if (path.length() > 0) {
+                        result.append(';');
+                }
+        }
+        return result;
+}
+
+Profiler::Ticks Profiler::totalTicks() const {
+        Ticks total = 0;
+        for (const Counter &counter : counters) {
+                total += counter.ticks;
+        }
+        return total;
+}
+
+size_t Profiler::totalExecutions() const {
+        size_t total = 0;
+        for (const Counter &counter : counters) {
+                total += counter.executions;
+        }
+        return total;
+}
+
+void Profiler::writeFoldedStacks(std::ostream &out) const {
+        for (size_t frame = 0; frame < frames.length(); ++frame) {
+                const Ticks ticks = frames[frame].unwrap().ticks;
+                if (ticks > 0) {
+                        out << framePath(frame) << ' ' << ticks << '\n';
+                }
+        }
+}
+
+/// Returns the indices of the non-empty counters, sorted by descending cost.
+static std::vector<size_t> sortByTicks(const std::vector<std::pair<size_t, uint64_t>> &costs) {
+        std::vector<size_t> order;
+        for (size_t i = 0; i < costs.size(); ++i) {
+                if (costs[i].first > 0) {
+                        order.push_back(i);
+                }
+        }
+        std::sort(order.begin(), order.end(),
+                  [&costs](size_t a, size_t b) { return costs[a].second > costs[b].second; });
+        return order;
+}
+
+static double percentage(uint64_t part, uint64_t total) {
+        if (total == 0) {
+                return 0;
+        }
+        return 100.0 * (double)part / (double)total;
+}
+
+void Profiler::writeSummary(std::ostream &out) const {
+        const Ticks total = totalTicks();
+
+        std::vector<std::pair<size_t, uint64_t>> instructionCosts;
+        const size_t labelCount = sourceMap.labelCount();
+        std::vector<std::pair<size_t, uint64_t>> labelCosts(labelCount + 1);
+        for (size_t i = 0; i < counters.length(); ++i) {
+                const Counter &counter = counters[i].unwrap();
+                instructionCosts.emplace_back(counter.executions, counter.ticks);
+
+                // Instructions before the first label are grouped in the last
+                // entry.
+                size_t label = sourceMap.getEnclosingLabel(i);
+                if (label == SourceMap::NO_LABEL) {
+                        label = labelCount;
+                }
+                labelCosts[label].first += counter.executions;
+                labelCosts[label].second += counter.ticks;
+        }
+
+        out << "Total: " << total << " ticks\n\n";
+        out << "Instructions by cost:\n";
+        out << std::setw(14) << "ticks" << std::setw(8) << "%" << std::setw(14) << "executions"
+            << std::setw(8) << "index" << std::setw(8) << "line"
+            << "  label\n";
+        const std::vector<size_t> instructionOrder = sortByTicks(instructionCosts);
+        for (size_t row = 0; row < instructionOrder.size() && row < SUMMARY_ROWS; ++row) {
+                const size_t i = instructionOrder[row];
+                out << std::setw(14) << instructionCosts[i].second << std::setw(8) << std::fixed
+                    << std::setprecision(2) << percentage(instructionCosts[i].second, total)
+                    << std::setw(14) << instructionCosts[i].first << std::setw(8) << i
+                    << std::setw(8) << sourceMap.getSourceLine(i) << "  "
+                    << sourceMap.labelName(sourceMap.getEnclosingLabel(i)) << '\n';
+        }
+
+        out << "\nLabels by cost:\n";
+        out << std::setw(14) << "ticks" << std::setw(8) << "%" << std::setw(14) << "executions"
+            << "  label\n";
+        const std::vector<size_t> labelOrder = sortByTicks(labelCosts);
+        for (size_t row = 0; row < labelOrder.size() && row < SUMMARY_ROWS; ++row) {
+                const size_t label = labelOrder[row];
+                out << std::setw(14) << labelCosts[label].second << std::setw(8) << std::fixed
+                    << std::setprecision(2) << percentage(labelCosts[label].second, total)
+                    << std::setw(14) << labelCosts[label].first << "  "
+                    << sourceMap.labelName(label < labelCount ? label : SourceMap::NO_LABEL) << '\n';
+        }
+}
@@ -0,0 +1,67 @@
+#include "program.h"
+
+#include "lazy_linker.h"
+
+Program::Program(const String &_name, Arena &&_arena, Vector<Box<Instruction>> &&_instructions,
+                 LabelTable &&_labels, SourceMap &&_sourceMap, Option<Box<LazyLinker>> &&_linker)
+    : arena(std::move(_arena)),
+      linker(std::move(_linker)),
+      name(_name),
+      instructions(std::move(_instructions)),
+      labels(std::move(_labels)),
+      sourceMap(std::move(_sourceMap)) {
+        if (linker.isSome()) {
+                linker.unwrap()->attach(*this);
+        }
+}
+
+Program::Program(Program &&other) noexcept
+    : arena(std::move(other.arena)),
+      linker(std::move(other.linker)),
+      name(std::move(other.name)),
+      instructions(std::move(other.instructions)),
+      labels(std::move(other.labels)),
+      sourceMap(std::move(other.sourceMap)) {
+        if (linker.isSome()) {
+                linker.unwrap()->attach(*this);
+        }
+}
+
+Program::~Program() = default;
+
+Program &Program::operator=(Program &&other) noexcept {
+        if (this != &other) {
+                instructions = std::move(other.instructions);
+                linker = std::move(other.linker);
+                arena = std::move(other.arena);
+                name = std::move(other.name);
+                labels = std::move(other.labels);
+                sourceMap = std::move(other.sourceMap);
+                if (linker.isSome()) {
+                        linker.unwrap()->attach(*this);
+                }
+        }
+        return *this;
+}
+
+const String &Program::getName() const {
+        return name;
+}
+
+const Vector<Box<Instruction>> &Program::getInstructions() const {
+        return instructions;
+}
+
+Option<size_t> Program::findLabel(StringView label) const {
+        return labels.find(label);
+}
+
+const SourceMap &Program::getSourceMap() const {
+        return sourceMap;
+}
+
+void Program::linkAll() const {
+        if (linker.isSome()) {
+                linker.unwrap()->linkAll();
+        }
+}
@@ -0,0 +1,130 @@
+#include "sampler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+#include <vector>
+
+std::atomic<bool> Sampler::pendingSample = false;
+
+void Sampler::handleSignal(int) {
+        pendingSample.store(true, std::memory_order_relaxed);
+}
+
+Sampler::Sampler(const SourceMap &_sourceMap) : sourceMap(_sourceMap) {
+        for (size_t i = 0; i <= sourceMap.labelCount(); ++i) {
+                selfSamples.pushBack(size_t(0));
+                totalSamples.pushBack(size_t(0));
+                lastSample.pushBack(size_t(0));
+        }
+}
+
+Sampler::~Sampler() {
+        stop();
+}
+
+void Sampler::start() {
+        if (running) {
+                return;
+        }
+
+        struct sigaction action = {};
+        action.sa_handler = handleSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+                throw std::runtime_error("Could not install the SIGPROF handler");
+        }
+
+        itimerval timer = {};
+        timer.it_interval.tv_usec = SAMPLING_INTERVAL_US;
+        timer.it_value.tv_usec = SAMPLING_INTERVAL_US;
+        if (setitimer(ITIMER_PROF, &timer, &previousTimer) != 0) {
+                sigaction(SIGPROF, &previousAction, nullptr);
+                throw std::runtime_error("Could not arm the profiling timer");
+        }
+        running = true;
+}
+
+void Sampler::stop() {
+        if (!running) {
+                return;
+        }
+        setitimer(ITIMER_PROF, &previousTimer, nullptr);
+        sigaction(SIGPROF, &previousAction, nullptr);
+        pendingSample.store(false, std::memory_order_relaxed);
+        running = false;
+}
+
+size_t Sampler::labelSlot(size_t instructionIdx) const {
+        if (instructionIdx >= sourceMap.instructionCount()) {
+                return sourceMap.labelCount();
+        }
+        const size_t label = sourceMap.getEnclosingLabel(instructionIdx);
+        if (label == SourceMap::NO_LABEL) {
+                return sourceMap.labelCount();
+        }
+        return label;
+}
+
+void Sampler::countLabel(size_t slot, bool isSelf) {
+        if (isSelf) {
+                selfSamples[slot].unwrap() += 1;
+        }
+        size_t &last = lastSample[slot].unwrap();
+        if (last != samples) {
+                last = samples;
+                totalSamples[slot].unwrap() += 1;
+        }
+}
+
+void Sampler::sample(const Vm &vm) {
+        pendingSample.store(false, std::memory_order_relaxed);
+        samples += 1;
+        countLabel(labelSlot(vm.getNextInstruction()), true);
+
+        // A frame popped by a plain `pop` is only dropped by the next
+        // `return`, so it is skipped here.
+        const size_t stackLength = vm.getStack().length();
+        for (const CallFrame &frame : callFrames) {
+                if (frame.stackPosition < stackLength) {
+                        countLabel(labelSlot(frame.callSite), false);
+                }
+        }
+}
+
+void Sampler::writeHistogram(std::ostream &out) const {
+        std::vector<size_t> order;
+        for (size_t slot = 0; slot < selfSamples.length(); ++slot) {
+                if (totalSamples[slot].unwrap() > 0) {
+                        order.push_back(slot);
+                }
+        }
+        std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+                return selfSamples[a].unwrap() > selfSamples[b].unwrap();
+        });
+
+        out << "Samples: " << samples << " (every " << SAMPLING_INTERVAL_US
+            << " us of CPU time)\n\n";
+        out << std::setw(10) << "self" << std::setw(8) << "%" << std::setw(10) << "total"
+            << std::setw(8) << "%"
+            << "  label\n";
+        for (size_t row = 0; row < order.size() && row < HISTOGRAM_ROWS; ++row) {
+                const size_t slot = order[row];
+                const size_t self = selfSamples[slot].unwrap();
+                const size_t total = totalSamples[slot].unwrap();
+                const double selfShare = (double)self / (double)samples;
+                const double totalShare = (double)total / (double)samples;
+                const size_t label = slot < sourceMap.labelCount() ? slot : SourceMap::NO_LABEL;
+
+                out << std::setw(10) << self << std::setw(8) << std::fixed << std::setprecision(2)
+                    << 100.0 * selfShare << std::setw(10) << total << std::setw(8)
+                    << 100.0 * totalShare << "  " << std::left << std::setw(24)
+                    << sourceMap.labelName(label) << std::right << ' ';
+                const size_t barWidth = (size_t)(selfShare * HISTOGRAM_BAR_WIDTH);
+                for (size_t i = 0; i < barWidth; ++i) {
+                        out << '#';
+                }
+                out << '\n';
+        }
+}
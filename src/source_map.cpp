@@ -0,0 +1,67 @@
+#include "source_map.h"
+
+#include "parser.h"
+
+SourceMap::SourceMap(const Parser &parser)
+    : files(parser.getFiles()), locations(parser.getSourceLocations()) {
+        for (size_t i = 0; i < locations.length(); ++i) {
+                labelAt.pushBack(size_t(NO_LABEL));
+        }
+
+        // Multiple labels could be declared at the same location, in which
+        // case the first declared one is used.
+        const LabelTable &labels = parser.getLabels();
+        const Vector<Symbol> &declared = labels.getDeclared();
+        for (size_t label = 0; label < declared.length(); ++label) {
+                const Symbol symbol = declared[label].unwrap();
+                labelNames.pushBack(String(labels.name(symbol)));
+                const size_t location = labels.locate(symbol).unwrap();
+                Option<size_t &> slot = labelAt[location];
+                if (slot.isSome() && slot.unwrap() == NO_LABEL) {
+                        slot.unwrap() = label;
+                }
+        }
+
+        size_t current = NO_LABEL;
+        for (size_t i = 0; i < locations.length(); ++i) {
+                if (labelAt[i].unwrap() != NO_LABEL) {
+                        current = labelAt[i].unwrap();
+                }
+                enclosingLabel.pushBack(size_t(current));
+        }
+}
+
+size_t SourceMap::instructionCount() const {
+        return locations.length();
+}
+
+size_t SourceMap::labelCount() const {
+        return labelNames.length();
+}
+
+const char *SourceMap::labelName(size_t label) const {
+        if (label == NO_LABEL) {
+                return "<unlabeled>";
+        }
+        return labelNames[label].unwrap().cStr();
+}
+
+size_t SourceMap::getLabelAt(size_t instructionIdx) const {
+        return labelAt[instructionIdx].unwrap();
+}
+
+size_t SourceMap::getEnclosingLabel(size_t instructionIdx) const {
+        return enclosingLabel[instructionIdx].unwrap();
+}
+
+size_t SourceMap::getSourceLine(size_t instructionIdx) const {
+        return getLocation(instructionIdx).line;
+}
+
+const SourceLocation &SourceMap::getLocation(size_t instructionIdx) const {
+        return locations[instructionIdx].unwrap();
+}
+
+const char *SourceMap::fileName(uint16_t file) const {
+        return files.name(file);
+}
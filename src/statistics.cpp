@@ -0,0 +1,91 @@
+#include "statistics.h"
+
+#include <iomanip>
+
+Statistics::Statistics(const Vector<Box<Instruction>> &instructions) {
+        for (size_t i = 0; i < instructions.length(); ++i) {
+                kinds.pushBack(classifyInstruction(*instructions[i].unwrap()));
+                branches.pushBack(BranchStats());
+        }
+}
+
+const RuntimeStats &Statistics::getStats() const {
+        return stats;
+}
+
+const BranchStats &Statistics::getBranchStats(size_t instructionIdx) const {
+        return branches[instructionIdx].expect("Branch statistics index out of range");
+}
+
+void Statistics::onStart(const Vm &vm) {
+        stats.stackHighWater = std::max(stats.stackHighWater, vm.getStack().length());
+        startTime = Clock::now();
+}
+
+void Statistics::afterInstruction(size_t instructionIdx, const Vm &vm) {
+        stats.instructionsRetired += 1;
+        switch (kinds[instructionIdx].unwrap()) {
+                case InstructionKind::Call:
+                        stats.calls += 1;
+                        callDepth += 1;
+                        stats.maxCallDepth = std::max(stats.maxCallDepth, callDepth);
+                        stats.stackHighWater =
+                            std::max(stats.stackHighWater, vm.getStack().length());
+                        break;
+                case InstructionKind::Return:
+                        stats.returns += 1;
+                        if (callDepth > 0) {
+                                callDepth -= 1;
+                        }
+                        break;
+                case InstructionKind::Branch: {
+                        BranchStats &branch = branches[instructionIdx].unwrap();
+                        if (vm.getNextInstruction() == instructionIdx + 1) {
+                                branch.taken += 1;
+                        } else {
+                                branch.notTaken += 1;
+                        }
+                        break;
+                }
+                case InstructionKind::Other:
+                        stats.stackHighWater =
+                            std::max(stats.stackHighWater, vm.getStack().length());
+                        break;
+        }
+}
+
+void Statistics::onFinish(const Vm &) {
+        stats.wallTime = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - startTime);
+}
+
+void Statistics::writeReport(std::ostream &out, const SourceMap &sourceMap) const {
+        const double seconds = (double)stats.wallTime.count() / 1e9;
+        out << "Instructions retired: " << stats.instructionsRetired << '\n';
+        out << "Calls:                " << stats.calls << '\n';
+        out << "Returns:              " << stats.returns << '\n';
+        out << "Max call depth:       " << stats.maxCallDepth << '\n';
+        out << "Stack high-water:     " << stats.stackHighWater << '\n';
+        out << "Wall time:            " << std::fixed << std::setprecision(6) << seconds << " s\n";
+        if (seconds > 0) {
+                out << "Instructions/s:       " << std::setprecision(0)
+                    << (double)stats.instructionsRetired / seconds << '\n';
+        }
+
+        bool hasBranches = false;
+        for (size_t i = 0; i < branches.length(); ++i) {
+                const BranchStats &branch = branches[i].unwrap();
+                if (branch.taken + branch.notTaken == 0) {
+                        continue;
+                }
+                if (!hasBranches) {
+                        out << "\nBranches:\n";
+                        out << std::setw(8) << "index" << std::setw(8) << "line" << std::setw(12)
+                            << "taken" << std::setw(12) << "not taken"
+                            << "  label\n";
+                        hasBranches = true;
+                }
+                out << std::setw(8) << i << std::setw(8) << sourceMap.getSourceLine(i)
+                    << std::setw(12) << branch.taken << std::setw(12) << branch.notTaken << "  "
+                    << sourceMap.labelName(sourceMap.getEnclosingLabel(i)) << '\n';
+        }
+}
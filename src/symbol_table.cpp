@@ -0,0 +1,164 @@
+#include "symbol_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "collections/hash.h"
+
+void SymbolTable::clone(const SymbolTable &other) {
+        chunkUsed = CHUNK_SIZE;
+        slots = other.slots;
+        for (const Entry &entry : other.entries) {
+                entries.pushBack(Entry{store(entry.name, entry.length), entry.length, entry.hash});
+        }
+}
+
+void SymbolTable::free() {
+        for (char *chunk : chunks) {
+                delete[] chunk;
+        }
+        chunks.clear();
+        entries.clear();
+        slots.clear();
+        chunkUsed = CHUNK_SIZE;
+}
+
+void SymbolTable::move(SymbolTable &&other) noexcept {
+        chunks = std::move(other.chunks);
+        chunkUsed = other.chunkUsed;
+        entries = std::move(other.entries);
+        slots = std::move(other.slots);
+        other.chunkUsed = CHUNK_SIZE;
+}
+
+const char *SymbolTable::store(const char *str, size_t length) {
+        const size_t size = length + 1;
+        char *result = nullptr;
+        if (size > CHUNK_SIZE) {
+                // Oversized strings get a chunk of their own, placed before the
+                // current chunk so that its free space remains in use.
+                result = new char[size];
+                chunks.pushBack(result);
+                if (chunks.length() > 1) {
+                        char *&last = chunks[chunks.length() - 1].unwrap();
+                        char *&current = chunks[chunks.length() - 2].unwrap();
+                        std::swap(last, current);
+                }
+        } else {
+                if (chunkUsed + size > CHUNK_SIZE) {
+                        chunks.pushBack(new char[CHUNK_SIZE]);
+                        chunkUsed = 0;
+                }
+                result = chunks[chunks.length() - 1].unwrap() + chunkUsed;
+                chunkUsed += size;
+        }
+        (void)memcpy(result, str, length);
+        result[length] = '\0';
+        return result;
+}
+
+size_t SymbolTable::findSlot(const char *str, size_t length, size_t hash) const {
+        const size_t mask = slots.length() - 1;
+        size_t slot = hash & mask;
+        while (true) {
+                const Symbol symbol = slots[slot].unwrap();
+                if (symbol == NO_SYMBOL) {
+                        return slot;
+                }
+                const Entry &entry = entries[symbol].unwrap();
+                if (entry.hash == hash && entry.length == length &&
+                    0 == memcmp(entry.name, str, length)) {
+                        return slot;
+                }
+                slot = (slot + 1) & mask;
+        }
+}
+
+void SymbolTable::grow() {
+        const size_t capacity = std::max(slots.length() * 2, INITIAL_SLOTS);
+        slots.clear();
+        slots.reserve(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+                slots.pushBack(NO_SYMBOL);
+        }
+        for (Symbol symbol = 0; symbol < entries.length(); ++symbol) {
+                const Entry &entry = entries[symbol].unwrap();
+                slots[findSlot(entry.name, entry.length, entry.hash)].unwrap() = symbol;
+        }
+}
+
+SymbolTable::SymbolTable(const SymbolTable &other) {
+        clone(other);
+}
+
+SymbolTable::SymbolTable(SymbolTable &&other) noexcept {
+        move(std::move(other));
+}
+
+SymbolTable::~SymbolTable() {
+        free();
+}
+
+SymbolTable &SymbolTable::operator=(const SymbolTable &other) {
+        if (this != &other) {
+                free();
+                clone(other);
+        }
+        return *this;
+}
+
+SymbolTable &SymbolTable::operator=(SymbolTable &&other) noexcept {
+        if (this != &other) {
+                free();
+                move(std::move(other));
+        }
+        return *this;
+}
+
+Symbol SymbolTable::intern(StringView view) {
+        const char *str = view.data();
+        const size_t length = view.length();
+        const size_t hash = vortex::hashBytes(str, length);
+        if (slots.length() == 0) {
+                grow();
+        }
+        size_t slot = findSlot(str, length, hash);
+        const Symbol existing = slots[slot].unwrap();
+        if (existing != NO_SYMBOL) {
+                return existing;
+        }
+
+        // The load factor is kept below 1/2, so the probe sequences are short.
+        if ((entries.length() + 1) * 2 > slots.length()) {
+                grow();
+                slot = findSlot(str, length, hash);
+        }
+        const Symbol symbol = (Symbol)entries.length();
+        entries.pushBack(Entry{store(str, length), length, hash});
+        slots[slot].unwrap() = symbol;
+        return symbol;
+}
+
+Option<Symbol> SymbolTable::find(StringView view) const {
+        if (slots.length() == 0) {
+                return Option<Symbol>();
+        }
+        const size_t hash = vortex::hashBytes(view.data(), view.length());
+        const Symbol symbol = slots[findSlot(view.data(), view.length(), hash)].unwrap();
+        if (symbol == NO_SYMBOL) {
+                return Option<Symbol>();
+        }
+        return Option<Symbol>(symbol);
+}
+
+const char *SymbolTable::name(Symbol symbol) const {
+        return entries[symbol].expect("Invalid symbol passed to SymbolTable::name()").name;
+}
+
+size_t SymbolTable::length(Symbol symbol) const {
+        return entries[symbol].expect("Invalid symbol passed to SymbolTable::length()").length;
+}
+
+size_t SymbolTable::size() const {
+        return entries.length();
+}
@@ -1,10 +1,64 @@
 #include "vm.h"
 
+#include <stdexcept>
+
+#include "program.h"
+
+Vm::Vm(MemoryResource &resource) : stack(resource) {
+}
+
 void Vm::execute(const Vector<Box<Instruction>> &instructions) {
-        while (nextInstruction < instructions.length()) {
-                const Box<Instruction> &instr = instructions[nextInstruction].unwrap();
-                instr->execute(*this);
+        NoObserver observer;
+        execute(instructions, observer);
+}
+
+void Vm::run(const Program &program, StringView entryLabel,
+             std::initializer_list<double> args) {
+        if (args.size() > REGISTER_COUNT) {
+                throw std::invalid_argument("More arguments than registers passed to Vm::run()");
+        }
+        const Option<size_t> entry = program.findLabel(entryLabel);
+        if (entry.isNone()) {
+                throw UnknownLabelException(Context(program.getName()), String(entryLabel));
+        }
+
+        reset();
+        size_t reg = 0;
+        for (const double arg : args) {
+                registers[reg++] = arg;
+        }
+        // A call frame past the end of the program lets the entry label be a
+        // regular function - its final `return` finishes the execution.
+        nextInstruction = program.getInstructions().length();
+        pushCallFrame();
+        nextInstruction = entry.unwrap();
+        execute(program.getInstructions());
+}
+
+void Vm::reset() {
+        nextInstruction = 0;
+        for (double &reg : registers) {
+                reg = 0;
+        }
+        stack.clear();
+}
+
+double Vm::getRegister(size_t reg) const {
+        if (reg >= REGISTER_COUNT) {
+                throw std::out_of_range("Invalid register index passed to Vm::getRegister()");
         }
+        return registers[reg];
+}
+
+void Vm::setRegister(size_t reg, double value) {
+        if (reg >= REGISTER_COUNT) {
+                throw std::out_of_range("Invalid register index passed to Vm::setRegister()");
+        }
+        registers[reg] = value;
+}
+
+const double *Vm::getRegisters() const {
+        return registers;
 }
 
 double Vm::getRegister(const Register &reg) const {
@@ -27,6 +81,10 @@ void Vm::goToNextInstruction() {
         nextInstruction += 1;
 }
 
+const Vector<double> &Vm::getStack() const {
+        return stack;
+}
+
 void Vm::push(double value) {
         stack.pushBack(value);
 }
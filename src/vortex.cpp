@@ -1,16 +1,85 @@
 
 #include "vortex.h"
 
+#include <sstream>
+
 #include "parser.h"
+#include "profiler.h"
+#include "sampler.h"
+#include "statistics.h"
+
+void Vortex::setMode(Mode _mode) {
+        mode = _mode;
+}
+
+void Vortex::setLazyLinking(bool enabled) {
+        lazyLinking = enabled;
+}
+
+Program Vortex::compile(const String &source, const String &name) {
+        std::istringstream sourceCode(source.cStr());
+        Parser parser;
+        return parser.compile(sourceCode, name);
+}
+
+Program Vortex::compileFile(const String &filename) {
+        Parser parser;
+        return parser.compileFile(filename);
+}
+
+void Vortex::profile(const Program &program, size_t entry) {
+        Profiler profiler(program.getInstructions(), program.getSourceMap(), entry);
+        vm.execute(program.getInstructions(), profiler);
+        profiler.writeSummary(std::cerr);
+
+        const String foldedFilename = program.getName() + FOLDED_STACKS_EXTENSION;
+        std::ofstream folded(foldedFilename.cStr());
+        profiler.writeFoldedStacks(folded);
+}
+
+void Vortex::sample(const Program &program) {
+        Sampler sampler(program.getSourceMap());
+        vm.execute(program.getInstructions(), sampler);
+        sampler.writeHistogram(std::cerr);
+}
+
+void Vortex::collectStats(const Program &program) {
+        Statistics statistics(program.getInstructions());
+        vm.execute(program.getInstructions(), statistics);
+        statistics.writeReport(std::cerr, program.getSourceMap());
+}
 
 void Vortex::execute(const String &filename) {
         try {
-                const Vector<Box<Instruction>> instructions = parser.parseFile(filename);
+                Parser parser;
+                parser.setLazyLinking(lazyLinking);
+                const Program program = parser.compileFile(filename);
+                const Option<size_t> entry = program.findLabel(ENTRYPOINT_LABEL);
+                if (entry.isNone()) {
+                        throw MissingEntryPointException(Context(filename));
+                }
+
+                // The instrumentation inspects every instruction up front.
+                if (mode != Mode::Run) {
+                        program.linkAll();
+                }
 
-                const size_t entry =
-                    parser.getLabels().get(ENTRYPOINT_LABEL).expect("No entry point found");
-                vm.setNextInstruction(entry);
-                vm.execute(instructions);
+                vm.reset();
+                vm.setNextInstruction(entry.unwrap());
+                switch (mode) {
+                        case Mode::Run:
+                                vm.execute(program.getInstructions());
+                                break;
+                        case Mode::Profile:
+                                profile(program, entry.unwrap());
+                                break;
+                        case Mode::Sample:
+                                sample(program);
+                                break;
+                        case Mode::Stats:
+                                collectStats(program);
+                                break;
+                }
 
         } catch (const VortexException &e) {
                 std::cerr << e.what() << std::endl;
@@ -23,7 +92,18 @@ void Vortex::execute(const String &filename) {
 }
 
 void Vortex::showSynopsis() {
-        std::cout << "Usage: vortext [<script>|help]" << std::endl;
+        std::cout << "Usage: vortext [--profile|--sample|--stats] [--lazy] [<script>|help]"
+                  << std::endl;
         std::cout << "A simple register-based virtual machine for executing programs.\n"
-                  << "Each program must have a `main` label as the entry point." << std::endl;
+                  << "Each program must have a `main` label as the entry point.\n\n"
+                  << "Options:\n"
+                  << "  --profile  print the cost of each instruction and label, and write\n"
+                  << "             the call stacks to `<script>" << FOLDED_STACKS_EXTENSION << "`\n"
+                  << "  --sample   periodically sample the executed label and print a histogram\n"
+                  << "             of the samples\n"
+                  << "  --stats    print the runtime statistics of the VM, such as the number\n"
+                  << "             of executed instructions and the maximum call depth\n"
+                  << "  --lazy     link each part of the script on its first execution,\n"
+                  << "             reporting most errors only once the code is executed"
+                  << std::endl;
 }
@@ -0,0 +1,662 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <set>
+#include <type_traits>
+#include <vector>
+
+#include "collections/avl.hpp"
+#include "collections/btree_map.hpp"
+#include "collections/hash_map.hpp"
+#include "collections/small_vector.hpp"
+#include "collections/string.h"
+#include "collections/vector.hpp"
+#include "arena.h"
+#include "harness.h"
+#include "symbol_table.h"
+
+/// The seed of the random workloads, fixed so that a failure is reproducible.
+static constexpr unsigned SEED = 42;
+
+/// The values from 0 up to the given count, in a random order.
+static std::vector<int> shuffledRange(int count) {
+        std::vector<int> values((size_t)count);
+        for (int i = 0; i < count; ++i) {
+                values[(size_t)i] = i;
+        }
+        std::mt19937 random(SEED);
+        std::shuffle(values.begin(), values.end(), random);
+        return values;
+}
+
+/// A string of the given length, whose characters depend on the seed.
+static String makeString(size_t length, char seed = 'a') {
+        String result;
+        for (size_t i = 0; i < length; ++i) {
+                result.append((char)(seed + (char)(i % 26)));
+        }
+        return result;
+}
+
+/// Passes the allocations to the heap, while keeping track of the allocated
+/// bytes.
+class CountingResource : public MemoryResource {
+       public:
+        size_t allocated = 0;
+        size_t peak = 0;
+
+        void *allocate(size_t size, size_t alignment) override {
+                allocated += size;
+                peak = std::max(peak, allocated);
+                return MemoryResource::allocate(nullptr, size, alignment);
+        }
+        void deallocate(void *ptr, size_t size, size_t alignment) override {
+                allocated -= size;
+                MemoryResource::deallocate(nullptr, ptr, size, alignment);
+        }
+};
+
+static void hashMapTests(TestSuite &suite) {
+        suite.run("hash_map/insert_and_lookup", []() {
+                HashMap<int, int> map;
+                for (const int key : shuffledRange(10000)) {
+                        map.insert(key, key * 2);
+                }
+                check(map.size() == 10000, "all keys are counted");
+                for (int key = 0; key < 10000; ++key) {
+                        const Option<int> value = map.get(key);
+                        check(value.isSome() && value.unwrap() == key * 2, "every key is found");
+                }
+                check(!map.contains(-1) && !map.contains(10000), "missing keys are not found");
+        });
+
+        suite.run("hash_map/duplicate_keys", []() {
+                HashMap<String, int> map;
+                map.insert("key", 1);
+                checkThrows<HashMapException>([&map]() { map.insert("key", 2); },
+                                              "inserting a present key is rejected");
+                check(map.get("key").unwrap() == 1 && map.size() == 1,
+                      "a rejected insertion keeps the value");
+
+                map.insertOrAssign("key", 3);
+                map.insertOrAssign("other", 4);
+                check(map.get("key").unwrap() == 3, "a present key is assigned");
+                check(map.get("other").unwrap() == 4, "an absent key is inserted");
+                check(map.size() == 2, "an assignment is not counted");
+        });
+
+        suite.run("hash_map/lookup_by_view", []() {
+                HashMap<String, size_t> map;
+                for (size_t i = 0; i < 100; ++i) {
+                        map.insert(String("key_") + String::fromNumber(i), i);
+                }
+                check(map.get(StringView("key_42")).unwrap() == 42, "found by a view");
+                check(map.get("key_7").unwrap() == 7, "found by a C string");
+                check(map.get("key_100").isNone(), "a missing key is not found by a C string");
+        });
+
+        suite.run("hash_map/erase", []() {
+                HashMap<int, int> map;
+                for (int key = 0; key < 1000; ++key) {
+                        map.insert(key, key);
+                }
+                for (int key = 0; key < 1000; key += 2) {
+                        check(map.erase(key), "a present key is erased");
+                }
+                check(!map.erase(0), "an erased key is not erased twice");
+                check(map.size() == 500, "the erased keys are not counted");
+                for (int key = 0; key < 1000; ++key) {
+                        check(map.contains(key) == (key % 2 == 1), "only the kept keys are found");
+                }
+                check(map.remove(1).unwrap() == 1 && map.remove(1).isNone(),
+                      "removing moves the value out once");
+        });
+
+        suite.run("hash_map/tombstone_reuse", []() {
+                // Inserting and erasing keys without growing the live set
+                // leaves deleted slots behind, which must be reused or cleaned
+                // up without losing any of the live keys.
+                static constexpr int LIVE = 50;
+                HashMap<int, int> map;
+                for (int key = 0; key < 100000; ++key) {
+                        map.insert(key, key);
+                        if (key >= LIVE) {
+                                check(map.erase(key - LIVE), "the oldest key is erased");
+                        }
+                }
+                check(map.size() == LIVE, "only the live keys are counted");
+                for (int key = 100000 - LIVE; key < 100000; ++key) {
+                        check(map.get(key).unwrap() == key, "every live key is found");
+                }
+                check(!map.contains(100000 - LIVE - 1), "an erased key is not found");
+        });
+
+        suite.run("hash_map/iteration", []() {
+                HashMap<int, int> map;
+                for (int key = 0; key < 5000; ++key) {
+                        map.insert(key, -key);
+                }
+                for (int key = 0; key < 5000; key += 3) {
+                        map.erase(key);
+                }
+                std::set<int> visited;
+                for (const auto &entry : map) {
+                        check(entry.getValue() == -entry.getKey(), "the entry holds its value");
+                        check(visited.insert(entry.getKey()).second, "each key is visited once");
+                }
+                check(visited.size() == map.size(), "every entry is visited");
+
+                for (auto &entry : map) {
+                        entry.getValue() *= 2;
+                }
+                const HashMap<int, int> &view = map;
+                for (auto &entry : view) {
+                        static_assert(std::is_const_v<std::remove_reference_t<decltype(entry)>>,
+                                      "a const map only views its entries");
+                        check(entry.getValue() == -2 * entry.getKey(),
+                              "the values are modified through a mutable map");
+                }
+        });
+}
+
+static void avlTreeTests(TestSuite &suite) {
+        suite.run("avl/insert_and_find", []() {
+                AvlTree<int> tree;
+                for (const int value : shuffledRange(10000)) {
+                        tree.insert(value);
+                }
+                check(tree.size() == 10000, "all values are counted");
+                for (int value = 0; value < 10000; ++value) {
+                        check(tree.find(value).unwrap() == value, "every value is found");
+                }
+                check(tree.find(-1).isNone() && tree.find(10000).isNone(),
+                      "missing values are not found");
+                checkThrows<AvlTreeException>([&tree]() { tree.insert(5); },
+                                              "a duplicate value is rejected");
+        });
+
+        suite.run("avl/build_from_sorted", []() {
+                for (const int count : {0, 1, 2, 3, 7, 100, 1000}) {
+                        Vector<int> values;
+                        for (int i = 0; i < count; ++i) {
+                                values.pushBack(i * 2);
+                        }
+                        AvlTree<int> tree = AvlTree<int>::buildFromSorted(std::move(values));
+                        check(tree.size() == (size_t)count, "all values are counted");
+                        for (int i = 0; i < count; ++i) {
+                                check(tree.find(i * 2).isSome(), "every value is found");
+                                check(tree.find(i * 2 + 1).isNone(), "a gap is not found");
+                        }
+                        // The built tree stays balanced for further insertions.
+                        tree.insert(-1);
+                        check(tree.find(-1).isSome(), "a value inserted afterwards is found");
+                }
+
+                Vector<int> unsorted;
+                unsorted.pushBack(2);
+                unsorted.pushBack(1);
+                checkThrows<AvlTreeException>(
+                    [&unsorted]() { (void)AvlTree<int>::buildFromSorted(std::move(unsorted)); },
+                    "unsorted values are rejected");
+        });
+}
+
+/// Checks that the map iterates exactly the keys from 0 up to the given count
+/// in ascending order, each mapped to its negation.
+static void checkBTreeContents(const BTreeMap<int, int> &map, int count) {
+        check(map.size() == (size_t)count, "all keys are counted");
+        int expected = 0;
+        for (const auto entry : map) {
+                check(entry.getKey() == expected, "the keys are iterated in ascending order");
+                check(entry.getValue() == -expected, "the entry holds its value");
+                expected += 1;
+        }
+        check(expected == count, "every entry is visited");
+}
+
+static void bTreeMapTests(TestSuite &suite) {
+        suite.run("btree/insert_and_iterate", []() {
+                BTreeMap<int, int> map;
+                for (const int key : shuffledRange(5000)) {
+                        map.insert(key, -key);
+                }
+                checkBTreeContents(map, 5000);
+                for (int key = 0; key < 5000; ++key) {
+                        check(map.getRef(key).unwrap() == -key, "every key is found");
+                }
+                check(map.get(5000).isNone(), "a missing key is not found");
+        });
+
+        suite.run("btree/range", []() {
+                BTreeMap<int, int> map;
+                for (const int key : shuffledRange(1000)) {
+                        map.insert(key * 2, key);
+                }
+                int expected = 100;
+                for (const auto entry : map.range(100, 200)) {
+                        check(entry.getKey() == expected, "the range is iterated in order");
+                        expected += 2;
+                }
+                check(expected == 200, "the range ends before its upper bound");
+                check((*map.lowerBound(101)).getKey() == 102,
+                      "the lower bound skips the smaller keys");
+        });
+
+        suite.run("btree/build_from_sorted", []() {
+                for (const int count : {0, 1, 31, 32, 33, 100, 1000, 5000}) {
+                        Vector<BTreeMap<int, int>::Entry> entries;
+                        for (int i = 0; i < count; ++i) {
+                                entries.emplaceBack(int(i), -i);
+                        }
+                        BTreeMap<int, int> map =
+                            BTreeMap<int, int>::buildFromSorted(std::move(entries));
+                        checkBTreeContents(map, count);
+
+                        // The built tree accepts further insertions.
+                        map.insert(count, -count);
+                        checkBTreeContents(map, count + 1);
+                }
+
+                Vector<BTreeMap<int, int>::Entry> unsorted;
+                unsorted.emplaceBack(2, 2);
+                unsorted.emplaceBack(1, 1);
+                checkThrows<std::invalid_argument>(
+                    [&unsorted]() {
+                            (void)BTreeMap<int, int>::buildFromSorted(std::move(unsorted));
+                    },
+                    "unsorted keys are rejected");
+        });
+}
+
+static void stringTests(TestSuite &suite) {
+        suite.run("string/inline_and_heap_boundary", []() {
+                // The lengths around the inline capacity switch between the
+                // inline buffer and the heap.
+                for (size_t length = 0; length <= 40; ++length) {
+                        const String original = makeString(length);
+                        check(original.length() == length, "the length is kept");
+                        check(strlen(original.cStr()) == length, "the string is null terminated");
+
+                        String copy(original);
+                        check(copy == original, "a copy is equal");
+
+                        String moved(std::move(copy));
+                        check(moved == original, "a moved string keeps the characters");
+                        check(copy.isEmpty() && copy.cStr()[0] == '\0',
+                              "a moved-from string is empty");
+
+                        String shortTarget("x");
+                        shortTarget = std::move(moved);
+                        check(shortTarget == original, "moving over an inline string");
+
+                        String longTarget = makeString(64, 'b');
+                        longTarget = std::move(shortTarget);
+                        check(longTarget == original, "moving over a heap string");
+
+                        longTarget.append('!');
+                        check(longTarget.length() == length + 1, "appending after a move");
+                }
+        });
+
+        suite.run("string/size", []() {
+                // The inline buffer, the length, the capacity, the cached hash
+                // and the resource, without any virtual table pointers.
+                check(sizeof(String) == 2 * sizeof(char *) + 3 * sizeof(size_t) +
+                                           sizeof(MemoryResource *),
+                      "a string takes 48 bytes on 64-bit targets");
+        });
+
+        suite.run("string/operations", []() {
+                checkEqual(String::fromNumber(0), "0", "zero is converted");
+                checkEqual(String::fromNumber(100), "100", "trailing zeros are kept");
+                checkEqual(String::fromNumber(12345), "12345", "all digits are kept");
+                checkEqual(String("  mov r1 2 ").trim(), "mov r1 2", "whitespace is trimmed");
+                checkEqual(String("label_name").substr(6, 10), "name", "the substring");
+
+                const Vector<String> tokens = String(" add  r1 r2 ").split(' ');
+                check(tokens.length() == 3, "empty tokens are skipped");
+                checkEqual(tokens[2].unwrap(), "r2", "the last token");
+
+                check(String("loop") < String("loop@1"), "a prefix orders first");
+                check(String("b") > String("abc"), "the first character decides");
+                check(String("same").hash() == String(StringView("same")).hash(),
+                      "equal strings hash equally");
+        });
+}
+
+/// Counts its copies, moves and live instances. It has no default constructor,
+/// so an empty `Option` must not build one.
+class Tracked {
+       public:
+        static inline size_t copies = 0;
+        static inline size_t moves = 0;
+        static inline long live = 0;
+
+        int value;
+
+        explicit Tracked(int _value) : value(_value) {
+                live += 1;
+        }
+        Tracked(const Tracked &other) : value(other.value) {
+                copies += 1;
+                live += 1;
+        }
+        Tracked(Tracked &&other) noexcept : value(other.value) {
+                moves += 1;
+                live += 1;
+        }
+        ~Tracked() {
+                live -= 1;
+        }
+
+        Tracked &operator=(const Tracked &other) {
+                value = other.value;
+                copies += 1;
+                return *this;
+        }
+        Tracked &operator=(Tracked &&other) noexcept {
+                value = other.value;
+                moves += 1;
+                return *this;
+        }
+
+        static void resetCounters() {
+                copies = 0;
+                moves = 0;
+        }
+};
+
+/// A value, whose move constructor may throw.
+struct ThrowingMove {
+        ThrowingMove() = default;
+        ThrowingMove(const ThrowingMove &) = default;
+        ThrowingMove(ThrowingMove &&) noexcept(false) {
+        }
+};
+
+static_assert(std::is_nothrow_move_constructible_v<Option<Tracked>> &&
+                  std::is_nothrow_move_assignable_v<Option<Tracked>>,
+              "Moving an option is noexcept, when moving its value is");
+static_assert(!std::is_nothrow_move_constructible_v<Option<ThrowingMove>> &&
+                  !std::is_nothrow_move_assignable_v<Option<ThrowingMove>>,
+              "Moving an option may throw, when moving its value may");
+
+static void optionTests(TestSuite &suite) {
+        suite.run("option/no_default_constructor", []() {
+                const Option<Tracked> empty;
+                check(empty.isNone(), "an empty option holds nothing");
+                check(Tracked::live == 0, "an empty option builds no value");
+
+                const Option<Tracked> set(Tracked(7));
+                check(set.isSome() && set.unwrap().value == 7, "a set option holds its value");
+        });
+
+        suite.run("option/unwrap_temporary_moves", []() {
+                Tracked::resetCounters();
+                const Tracked unwrapped = Option<Tracked>(Tracked(1)).unwrap();
+                const Tracked expected = Option<Tracked>(Tracked(2)).expect("set");
+                check(unwrapped.value == 1 && expected.value == 2, "the values are moved out");
+                check(Tracked::copies == 0, "unwrapping a temporary does not copy");
+
+                Option<Tracked> named(Tracked(3));
+                Tracked::resetCounters();
+                const Tracked moved = std::move(named).unwrap();
+                check(moved.value == 3 && Tracked::copies == 0 && Tracked::moves == 1,
+                      "unwrapping a moved option moves its value once");
+        });
+
+        suite.run("option/destroyed_once", []() {
+                {
+                        Option<Tracked> first(Tracked(1));
+                        Option<Tracked> second(Tracked(2));
+                        Option<Tracked> empty;
+                        check(Tracked::live == 2, "each set option holds one value");
+
+                        first = second;
+                        check(Tracked::live == 2, "a copy assignment replaces the value");
+                        second = std::move(first);
+                        check(Tracked::live == 2, "a move assignment replaces the value");
+                        first = empty;
+                        check(Tracked::live == 1, "assigning an empty option destroys the value");
+                        second = Option<Tracked>();
+                        check(Tracked::live == 0, "moving an empty option destroys the value");
+
+                        second = Option<Tracked>(Tracked(3));
+                        Option<Tracked> &alias = second;
+                        second = alias;
+                        second = std::move(alias);
+                        check(second.unwrap().value == 3 && Tracked::live == 1,
+                              "a self assignment keeps the value");
+                }
+                check(Tracked::live == 0, "the destructors release every value");
+        });
+
+        suite.run("option/pop_back_moves", []() {
+                {
+                        Vector<Tracked> vector;
+                        for (int i = 0; i < 10; ++i) {
+                                vector.emplaceBack(i);
+                        }
+                        Tracked::resetCounters();
+                        const Tracked popped = vector.popBack().unwrap();
+                        check(popped.value == 9, "the last element is popped");
+                        check(Tracked::copies == 0, "the popped element is not copied");
+                }
+                check(Tracked::live == 0, "the popped and the remaining elements are released");
+        });
+}
+
+static void vectorTests(TestSuite &suite) {
+        suite.run("vector/fifo", []() {
+                // Random pushes and pops from both ends, compared to a deque.
+                std::mt19937 random(SEED);
+                Vector<String> vector;
+                std::deque<String> expected;
+                for (size_t i = 0; i < 100000; ++i) {
+                        const auto operation = random() % 5;
+                        if (operation < 3) {
+                                const String value = makeString(random() % 32);
+                                vector.pushBack(value);
+                                expected.push_back(value);
+                        } else if (operation == 3) {
+                                const Option<String> popped = vector.popFront();
+                                check(popped.isSome() == !expected.empty(), "popping the front");
+                                if (!expected.empty()) {
+                                        check(popped.unwrap() == expected.front(),
+                                              "the front element is popped");
+                                        expected.pop_front();
+                                }
+                        } else {
+                                const Option<String> popped = vector.popBack();
+                                check(popped.isSome() == !expected.empty(), "popping the back");
+                                if (!expected.empty()) {
+                                        check(popped.unwrap() == expected.back(),
+                                              "the back element is popped");
+                                        expected.pop_back();
+                                }
+                        }
+                        check(vector.length() == expected.size(), "the length matches");
+                }
+                size_t idx = 0;
+                for (const String &value : vector) {
+                        check(value == expected[idx++], "the elements are kept in order");
+                }
+        });
+
+        suite.run("vector/fifo_bounded_capacity", []() {
+                // A queue of a constant length must not grow its storage,
+                // however many elements pass through it.
+                static constexpr size_t QUEUE_LENGTH = 100;
+                CountingResource resource;
+                {
+                        Vector<String> queue(resource);
+                        for (size_t i = 0; i < 200000; ++i) {
+                                queue.pushBack(String::fromNumber(i));
+                                if (i >= QUEUE_LENGTH) {
+                                        checkEqual(queue.popFront().unwrap(),
+                                                   String::fromNumber(i - QUEUE_LENGTH),
+                                                   "the oldest element is popped");
+                                }
+                        }
+                        check(queue.length() == QUEUE_LENGTH, "the queue keeps its length");
+                }
+                check(resource.allocated == 0, "the storage is released");
+                check(resource.peak <= 8 * QUEUE_LENGTH * sizeof(String),
+                      "the capacity stays bounded");
+        });
+
+        suite.run("vector/copy_and_move", []() {
+                Vector<String> original;
+                for (size_t i = 0; i < 100; ++i) {
+                        original.pushBack(makeString(i));
+                }
+                (void)original.popFront();
+                Vector<String> copy(original);
+                check(copy.length() == 99, "a copy keeps the length");
+                Vector<String> moved(std::move(copy));
+                check(moved.length() == 99 && copy.length() == 0, "a move takes the elements");
+                for (size_t i = 0; i < 99; ++i) {
+                        check(moved[i].unwrap() == makeString(i + 1), "the elements are kept");
+                }
+        });
+
+        suite.run("small_vector/inline_and_heap", []() {
+                SmallVector<String, 3> vector;
+                for (size_t i = 0; i < 10; ++i) {
+                        vector.pushBack(makeString(i * 4));
+                }
+                check(vector.length() == 10, "the elements outgrow the inline storage");
+                for (size_t i = 10; i > 0; --i) {
+                        check(vector.popBack().unwrap() == makeString((i - 1) * 4),
+                              "the elements are popped in reverse");
+                }
+                check(vector.popBack().isNone(), "an empty vector has nothing to pop");
+        });
+}
+
+static void symbolTableTests(TestSuite &suite) {
+        suite.run("symbol_table/intern", []() {
+                SymbolTable table;
+                check(table.find("missing").isNone(), "an empty table finds nothing");
+                for (size_t i = 0; i < 1000; ++i) {
+                        const String name = String("label_") + String::fromNumber(i);
+                        check(table.intern(name) == (Symbol)i, "the symbols are consecutive");
+                }
+                check(table.intern("label_7") == 7, "interning again returns the symbol");
+                check(table.find("label_999").unwrap() == 999, "a string is found");
+                checkEqual(String(table.name(42)), "label_42", "the name of a symbol");
+        });
+
+        suite.run("symbol_table/moved_from", []() {
+                SymbolTable table;
+                (void)table.intern("first");
+                SymbolTable moved(std::move(table));
+                check(moved.find("first").unwrap() == 0, "a moved table keeps the strings");
+
+                // The moved-from table is empty and keeps working.
+                check(table.size() == 0 && table.find("first").isNone(), "the origin is empty");
+                check(table.intern("second") == 0, "the origin interns again");
+                check(table.intern("second") == 0, "the origin finds the interned string");
+
+                SymbolTable assigned;
+                (void)assigned.intern("other");
+                assigned = std::move(moved);
+                check(assigned.find("first").unwrap() == 0, "an assigned table takes the strings");
+                check(moved.intern("third") == 0 && moved.find("third").unwrap() == 0,
+                      "the assigned-from table interns again");
+        });
+}
+
+/// Whether the pointer is a multiple of the alignment.
+static bool isAligned(const void *ptr, size_t alignment) {
+        return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+/// Hands out memory, which is aligned to `max_align_t`, but never to anything
+/// larger, regardless of the requested alignment.
+class MisalignedResource : public MemoryResource {
+       private:
+        static constexpr size_t OFFSET = alignof(std::max_align_t);
+        static constexpr std::align_val_t BASE_ALIGNMENT = std::align_val_t(4096);
+
+       public:
+        void *allocate(size_t size, size_t) override {
+                return static_cast<char *>(::operator new(size + OFFSET, BASE_ALIGNMENT)) + OFFSET;
+        }
+        void deallocate(void *ptr, size_t, size_t) override {
+                ::operator delete(static_cast<char *>(ptr) - OFFSET, BASE_ALIGNMENT);
+        }
+};
+
+/// Allocates a block of every size class of the pool, each aligned to its size,
+/// and checks that they are aligned and do not overlap.
+static void checkPoolBlocks(PoolResource &pool) {
+        std::vector<std::pair<char *, size_t>> blocks;
+        for (size_t round = 0; round < 200; ++round) {
+                for (size_t size = 16; size <= 1024; size *= 2) {
+                        char *block = static_cast<char *>(pool.allocate(size, size));
+                        check(isAligned(block, size), "the block is aligned to its size");
+                        memset(block, (int)(round % 256), size);
+                        blocks.emplace_back(block, size);
+                }
+        }
+        std::sort(blocks.begin(), blocks.end());
+        for (size_t i = 1; i < blocks.size(); ++i) {
+                check(blocks[i - 1].first + blocks[i - 1].second <= blocks[i].first,
+                      "the blocks do not overlap");
+        }
+        for (const auto &[block, size] : blocks) {
+                pool.deallocate(block, size, size);
+        }
+}
+
+static void memoryResourceTests(TestSuite &suite) {
+        suite.run("arena/alignment", []() {
+                // The alignments above `max_align_t` are honored in a fresh
+                // chunk, in the middle of a chunk and in an oversized chunk.
+                for (const size_t alignment : {size_t(64), size_t(256), size_t(4096)}) {
+                        Arena arena;
+                        for (const size_t size : {size_t(1), size_t(100), size_t(200000)}) {
+                                void *ptr = arena.allocate(size, alignment);
+                                check(isAligned(ptr, alignment), "the allocation is aligned");
+                                memset(ptr, 0xAB, size);
+                                check(isAligned(arena.allocate(3, 1), 1), "a byte allocation");
+                        }
+                }
+        });
+
+        suite.run("pool/alignment", []() {
+                // The pool aligns its blocks itself, so it works on top of any
+                // upstream, which aligns to `max_align_t`.
+                MisalignedResource misaligned;
+                Arena arena;
+                PoolResource heapPool;
+                PoolResource misalignedPool(&misaligned);
+                PoolResource arenaPool(&arena);
+                checkPoolBlocks(heapPool);
+                checkPoolBlocks(misalignedPool);
+                checkPoolBlocks(arenaPool);
+        });
+}
+
+int main(int argc, char *argv[]) {
+        try {
+                TestSuite suite("collections", argc, argv);
+                hashMapTests(suite);
+                avlTreeTests(suite);
+                bTreeMapTests(suite);
+                stringTests(suite);
+                optionTests(suite);
+                vectorTests(suite);
+                symbolTableTests(suite);
+                memoryResourceTests(suite);
+                return suite.report(std::cout);
+
+        } catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+        }
+}
@@ -0,0 +1,76 @@
+#include "harness.h"
+
+#include <cstring>
+#include <stdexcept>
+
+/// Formats the location of a failed check as `file:line`.
+static String describeLocation(const std::source_location &location) {
+        return String(location.file_name()) + ":" + String::fromNumber(location.line());
+}
+
+TestFailure::TestFailure(const String &_message) : message(_message) {
+}
+
+const char *TestFailure::what() const noexcept {
+        return message.cStr();
+}
+
+void check(bool condition, const char *description, std::source_location location) {
+        if (!condition) {
+                throw TestFailure(describeLocation(location) + ": " + description);
+        }
+}
+
+void checkEqual(const String &actual, const String &expected, const char *description,
+                std::source_location location) {
+        if (!(actual == expected)) {
+                throw TestFailure(describeLocation(location) + ": " + description +
+                                  "\n  expected: \"" + expected + "\"\n  actual:   \"" + actual +
+                                  "\"");
+        }
+}
+
+TestSuite::TestSuite(const String &_suiteName, int argc, char *argv[]) : suiteName(_suiteName) {
+        for (int i = 1; i < argc; ++i) {
+                const char *option = argv[i];
+                if (i + 1 >= argc) {
+                        const String msg = String("Missing value for option: ") + option;
+                        throw std::invalid_argument(msg.cStr());
+                }
+                const char *value = argv[++i];
+
+                if (0 == strcmp(option, "--filter")) {
+                        filter = value;
+                } else {
+                        const String msg = String("Unknown option: ") + option;
+                        throw std::invalid_argument(msg.cStr());
+                }
+        }
+}
+
+bool TestSuite::isSelected(const String &name) const {
+        return filter.isEmpty() || strstr(name.cStr(), filter.cStr()) != nullptr;
+}
+
+void TestSuite::run(const String &name, const std::function<void()> &testCase) {
+        if (!isSelected(name)) {
+                return;
+        }
+        try {
+                testCase();
+                passed += 1;
+        } catch (const TestFailure &e) {
+                failures.push_back(name + ": " + e.what());
+        } catch (const std::exception &e) {
+                failures.push_back(name + ": unexpected exception: " + e.what());
+        }
+}
+
+int TestSuite::report(std::ostream &out) const {
+        for (const String &failure : failures) {
+                out << "FAILED " << failure << "\n";
+        }
+        out << suiteName << ": " << passed << " passed, " << failures.size() << " failed"
+            << std::endl;
+        return failures.empty() ? 0 : 1;
+}
@@ -0,0 +1,72 @@
+#ifndef VORTEX_TESTS_HARNESS_H
+#define VORTEX_TESTS_HARNESS_H
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <ostream>
+#include <source_location>
+#include <vector>
+
+#include "collections/string.h"
+
+/// Thrown by a failed check, stopping the test case it is raised in.
+class TestFailure : public std::exception {
+       private:
+        String message;
+
+       public:
+        TestFailure(const String &);
+
+        const char *what() const noexcept override;
+};
+
+/// Fails the current test case, unless the condition holds. The failure
+/// reports the description along with the location of the check.
+void check(bool, const char *, std::source_location = std::source_location::current());
+
+/// Fails the current test case, unless the two strings are equal. Both
+/// strings are reported on failure.
+void checkEqual(const String &, const String &, const char *,
+                std::source_location = std::source_location::current());
+
+/// Fails the current test case, unless the function throws an exception of the
+/// given type.
+template <typename E>
+void checkThrows(const std::function<void()> &function, const char *description,
+                 std::source_location location = std::source_location::current()) {
+        try {
+                function();
+        } catch (const E &) {
+                return;
+        }
+        check(false, description, location);
+}
+
+/// A minimal test runner, which executes each registered test case, catching
+/// its failures and any unexpected exceptions, and reports the failed cases.
+///
+/// The behaviour is controlled through the command line arguments:
+/// ```
+/// --filter <text>  only runs the test cases, whose name contains the text
+/// ```
+class TestSuite {
+       private:
+        String suiteName;
+        String filter;
+        size_t passed = 0;
+        std::vector<String> failures;
+
+       public:
+        TestSuite(const String &, int, char *[]);
+
+        bool isSelected(const String &) const;
+        /// Runs the test case, unless it is filtered out.
+        void run(const String &, const std::function<void()> &);
+
+        /// Prints the summary and the failures. Returns the exit code of the
+        /// test binary.
+        int report(std::ostream &) const;
+};
+
+#endif
@@ -0,0 +1,198 @@
+#include <dirent.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "harness.h"
+#include "host_function.h"
+#include "parser.h"
+#include "program.h"
+#include "vm.h"
+
+/// The directories of the scripts, which are executed in every parsing mode.
+static const char *const SCRIPT_DIRECTORIES[] = {"examples", "tests/scripts"};
+/// The extension of the file holding the expected result of a script.
+static const char *const EXPECTED_EXTENSION = ".expected";
+
+/// A way of configuring the parser, whose programs must behave identically to
+/// the ones of every other mode.
+struct ParsingMode {
+        const char *name;
+        void (*configure)(Parser &);
+};
+
+static const ParsingMode MODES[] = {
+    {"two_pass", [](Parser &) {}},
+    {"two_pass_no_inlining", [](Parser &parser) { parser.setInlining(false); }},
+    {"single_pass", [](Parser &parser) { parser.setSinglePass(true); }},
+    {"parallel", [](Parser &parser) { parser.setThreads(4); }},
+    {"lazy", [](Parser &parser) { parser.setLazyLinking(true); }},
+};
+
+/// Runs the program from its `main` label and returns everything it printed.
+/// A failure while compiling or running the program is returned as its
+/// message instead, so the errors are compared along with the output.
+static String runProgram(const std::function<Program()> &compile) {
+        std::ostringstream output;
+        std::streambuf *const original = std::cout.rdbuf(output.rdbuf());
+        String result;
+        try {
+                const Program program = compile();
+                Vm vm;
+                vm.run(program, "main");
+                result = String(output.str().c_str());
+        } catch (const std::exception &e) {
+                result = String(output.str().c_str()) + "error: " + e.what() + "\n";
+        }
+        std::cout.rdbuf(original);
+        return result;
+}
+
+static String runFile(const ParsingMode &mode, const String &filename) {
+        return runProgram([&mode, &filename]() {
+                Parser parser;
+                mode.configure(parser);
+                return parser.compileFile(filename);
+        });
+}
+
+static Option<String> readFile(const String &filename) {
+        std::ifstream file(filename.cStr());
+        if (!file) {
+                return Option<String>();
+        }
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return Option<String>(String(contents.str().c_str()));
+}
+
+/// The scripts of the directory, sorted by name.
+static std::vector<String> listScripts(const char *directory) {
+        std::vector<String> scripts;
+        DIR *dir = opendir(directory);
+        if (nullptr == dir) {
+                return scripts;
+        }
+        while (const dirent *entry = readdir(dir)) {
+                const String name(entry->d_name);
+                if (name.length() > 3 && name.substr(name.length() - 3, name.length()) == ".vx") {
+                        scripts.push_back(String(directory) + "/" + name);
+                }
+        }
+        closedir(dir);
+        std::sort(scripts.begin(), scripts.end());
+        return scripts;
+}
+
+/// A source, which is large enough to be split into several chunks by the
+/// parallel mode. The calls and jumps cross the chunk boundaries in both
+/// directions.
+static String generateLargeSource(size_t functionCount) {
+        String source("main:\n        mov r0 0\n        jmp entry\n");
+        for (size_t i = 0; i < functionCount; ++i) {
+                const String name = String("f") + String::fromNumber(i);
+                source.append((String("; adds a constant to r0, wrapping around a bound\n") + name +
+                               ":\n        add r0 " + String::fromNumber(i % 7) +
+                               "\n        ifgt r0 1000\n                jmp " + name +
+                               "_wrap\n        return\n" + name + "_wrap:\n        sub r0 1000\n" +
+                               "        return\n")
+                                  .cStr());
+        }
+        source.append("entry:\n");
+        for (size_t i = 0; i < functionCount; ++i) {
+                source.append((String("        call f") + String::fromNumber(i) + "\n").cStr());
+        }
+        source.append("        print r0\n");
+        return source;
+}
+
+static void scriptTests(TestSuite &suite) {
+        for (const char *directory : SCRIPT_DIRECTORIES) {
+                for (const String &script : listScripts(directory)) {
+                        suite.run(String("modes/") + script, [&script]() {
+                                const String expected = runFile(MODES[0], script);
+                                for (const ParsingMode &mode : MODES) {
+                                        checkEqual(runFile(mode, script), expected, mode.name);
+                                }
+
+                                const Option<String> recorded =
+                                    readFile(script + EXPECTED_EXTENSION);
+                                if (recorded.isSome()) {
+                                        checkEqual(expected, recorded.unwrap(),
+                                                   "the recorded result");
+                                }
+                        });
+                }
+        }
+}
+
+static void inliningTests(TestSuite &suite) {
+        suite.run("inlining/native_call_sees_call_frame", []() {
+                // A raw host function receives the whole VM, so a body calling
+                // one must keep its call frame on the stack.
+                HostFunctions hostFunctions;
+                hostFunctions.define("stack_depth",
+                                     [](Vm &vm) { return (double)vm.getStack().length(); });
+                const String source("depth:\n        ncall stack_depth\n        return\n"
+                                    "main:\n        call depth\n        print r0\n");
+
+                for (const bool inlining : {true, false}) {
+                        const String output = runProgram([&hostFunctions, &source, inlining]() {
+                                std::istringstream stream(source.cStr());
+                                Parser parser(hostFunctions);
+                                parser.setInlining(inlining);
+                                return parser.compile(stream, "depth.vx");
+                        });
+                        // The frame of `Vm::run` along with the one of the call.
+                        checkEqual(output, "2\n", "the host function sees the call frame");
+                }
+        });
+}
+
+static void parallelTests(TestSuite &suite) {
+        suite.run("parallel/many_chunks", []() {
+                const String source = generateLargeSource(4000);
+                check(source.length() > 4 * 64 * 1024, "the source spans several chunks");
+
+                const String expected = runProgram([&source]() {
+                        std::istringstream stream(source.cStr());
+                        Parser parser;
+                        return parser.compile(stream, "large.vx");
+                });
+                check(!expected.startsWith('e'), "the source runs");
+
+                for (const size_t threads : {size_t(2), size_t(4), size_t(8)}) {
+                        const String actual = runProgram([&source, threads]() {
+                                Parser parser;
+                                parser.setThreads(threads);
+                                return parser.compileParallel(source, "large.vx");
+                        });
+                        checkEqual(actual, expected, "the parallel result");
+                }
+
+                const String lazy = runProgram([&source]() {
+                        std::istringstream stream(source.cStr());
+                        Parser parser;
+                        parser.setLazyLinking(true);
+                        return parser.compile(stream, "large.vx");
+                });
+                checkEqual(lazy, expected, "the lazy result");
+        });
+}
+
+int main(int argc, char *argv[]) {
+        try {
+                TestSuite suite("parser", argc, argv);
+                scriptTests(suite);
+                inliningTests(suite);
+                parallelTests(suite);
+                return suite.report(std::cout);
+
+        } catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+        }
+}
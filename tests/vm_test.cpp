@@ -0,0 +1,226 @@
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "collections/memory_resource.h"
+#include "error.h"
+#include "harness.h"
+#include "host_function.h"
+#include "parser.h"
+#include "program.h"
+#include "statistics.h"
+#include "vm.h"
+
+/// Compiles the source with the default parser configuration.
+static Program compileSource(const char *source) {
+        std::istringstream stream(source);
+        Parser parser;
+        return parser.compile(stream, "test.vx");
+}
+
+/// Compiles a program, whose `main` calls the host function with the given
+/// arguments, and returns the result left in `r0`.
+static double callHostFunction(const HostFunctions &hostFunctions, const char *name,
+                               std::initializer_list<double> args) {
+        std::istringstream stream(
+            (String("main:\n        ncall ") + name + "\n        return\n").cStr());
+        Parser parser(hostFunctions);
+        const Program program = parser.compile(stream, "host.vx");
+        Vm vm;
+        vm.run(program, "main", args);
+        return vm.getRegister(0);
+}
+
+static double answer() {
+        return 42;
+}
+
+/// Weighs each argument differently, so that the result depends on their
+/// order.
+static double weighted(double first, double second, double third) {
+        return first - 2 * second + 3 * third;
+}
+
+static double stackLength(Vm &vm) {
+        return (double)vm.getStack().length();
+}
+
+/// Passes the allocations to the heap, while counting them.
+class CountingResource : public MemoryResource {
+       public:
+        size_t allocations = 0;
+
+        void *allocate(size_t size, size_t alignment) override {
+                allocations += 1;
+                return MemoryResource::allocate(nullptr, size, alignment);
+        }
+        void deallocate(void *ptr, size_t size, size_t alignment) override {
+                MemoryResource::deallocate(nullptr, ptr, size, alignment);
+        }
+};
+
+/// Runs the function, while discarding everything printed to the standard
+/// output.
+static void silenced(const std::function<void()> &function) {
+        std::ostringstream output;
+        std::streambuf *const original = std::cout.rdbuf(output.rdbuf());
+        try {
+                function();
+        } catch (...) {
+                std::cout.rdbuf(original);
+                throw;
+        }
+        std::cout.rdbuf(original);
+}
+
+static void statisticsTests(TestSuite &suite) {
+        suite.run("statistics/fib", []() {
+                // Executed the same way as `vortex --stats examples/fib.vx`,
+                // which computes fib(15).
+                Parser parser;
+                const Program program = parser.compileFile("examples/fib.vx");
+                program.linkAll();
+                Statistics statistics(program.getInstructions());
+                Vm vm;
+                vm.setNextInstruction(program.findLabel("main").unwrap());
+                silenced([&]() { vm.execute(program.getInstructions(), statistics); });
+
+                const RuntimeStats &stats = statistics.getStats();
+                check(stats.instructionsRetired == 9751, "the retired instructions");
+                check(stats.calls == 1219, "the calls");
+                check(stats.returns == 1219, "the returns");
+                check(stats.maxCallDepth == 14, "the maximum call depth");
+
+                // The `iflteq` at the start of `fib`.
+                const BranchStats &branch = statistics.getBranchStats(0);
+                check(branch.taken == 610, "the taken branches");
+                check(branch.notTaken == 609, "the branches not taken");
+                check(statistics.getBranchStats(1).taken == 0,
+                      "the counters of any other instruction");
+        });
+}
+
+static void embeddingTests(TestSuite &suite) {
+        suite.run("embedding/run_with_arguments", []() {
+                const Program program = compileSource("sum:\n"
+                                                      "        add r0 r1\n"
+                                                      "        return\n");
+                Vm vm;
+                vm.run(program, "sum", {2, 3});
+                check(vm.getRegister(0) == 5, "the result of the first run");
+                check(vm.getStack().length() == 0, "the stack after the first run");
+
+                // The same program is run again, without being compiled.
+                vm.run(program, "sum", {10, -4});
+                check(vm.getRegister(0) == 6, "the result of the second run");
+
+                // The registers past the arguments start from zero.
+                vm.run(program, "sum", {7});
+                check(vm.getRegister(0) == 7, "the result of a single argument");
+                check(vm.getRegister(1) == 0, "the register past the arguments");
+        });
+
+        suite.run("embedding/reset", []() {
+                // Falls off the end of the program, leaving the values along
+                // with the call frame of `Vm::run` on the stack.
+                const Program program = compileSource("fill:\n"
+                                                      "        push r1\n"
+                                                      "        add r1 1\n"
+                                                      "        iflt r1 1000\n"
+                                                      "                jmp fill\n");
+                CountingResource resource;
+                Vm vm(resource);
+                vm.run(program, "fill");
+                check(vm.getStack().length() == 1001, "the stack after the run");
+                check(vm.getRegister(1) == 1000, "the register after the run");
+
+                vm.reset();
+                check(vm.getStack().length() == 0, "the stack is cleared");
+                check(vm.getRegister(1) == 0, "the registers are cleared");
+                check(vm.getNextInstruction() == 0, "the next instruction is rewound");
+
+                // The stack keeps its capacity, so the same run does not
+                // allocate again.
+                const size_t allocations = resource.allocations;
+                vm.run(program, "fill");
+                check(vm.getStack().length() == 1001, "the stack after running again");
+                check(resource.allocations == allocations, "the stack keeps its capacity");
+        });
+
+        suite.run("embedding/invalid_run", []() {
+                const Program program = compileSource("main:\n"
+                                                      "        return\n");
+                Vm vm;
+                checkThrows<UnknownLabelException>([&]() { vm.run(program, "missing"); },
+                                                   "an unknown entry label");
+                checkThrows<std::invalid_argument>(
+                    [&]() {
+                            vm.run(program, "main",
+                                   {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16});
+                    },
+                    "more arguments than registers");
+        });
+}
+
+static void hostFunctionTests(TestSuite &suite) {
+        suite.run("host_functions/raw", []() {
+                HostFunctions hostFunctions;
+                hostFunctions.define("stack_length", stackLength);
+                hostFunctions.define("double_r3", [](Vm &vm) { return 2 * vm.getRegister(3); });
+                // The call frame of `Vm::run`.
+                check(callHostFunction(hostFunctions, "stack_length", {}) == 1,
+                      "a raw function reads the stack");
+                check(callHostFunction(hostFunctions, "double_r3", {0, 0, 0, 21}) == 42,
+                      "a raw function reads any register");
+        });
+
+        suite.run("host_functions/typed", []() {
+                HostFunctions hostFunctions;
+                hostFunctions.define("answer", answer);
+                hostFunctions.define("weighted", weighted);
+                hostFunctions.define("square", [](double x) { return x * x; });
+                hostFunctions.define("truncate", [](int whole, double fraction) {
+                        return (double)whole + fraction;
+                });
+
+                check(callHostFunction(hostFunctions, "answer", {7}) == 42, "no arguments");
+                check(callHostFunction(hostFunctions, "square", {-3}) == 9, "a single argument");
+                // The arguments are read from r0, r1 and r2 in order.
+                check(callHostFunction(hostFunctions, "weighted", {3, 4, 5}) == 10,
+                      "several arguments");
+                check(callHostFunction(hostFunctions, "truncate", {2.75, 0.5}) == 2.5,
+                      "the arguments are converted to the parameter types");
+        });
+
+        suite.run("host_functions/duplicate", []() {
+                HostFunctions hostFunctions;
+                hostFunctions.define("answer", answer);
+                checkThrows<std::invalid_argument>(
+                    [&]() { hostFunctions.define("answer", [](double x) { return x; }); },
+                    "a name defined twice");
+                check(callHostFunction(hostFunctions, "answer", {}) == 42,
+                      "the first definition is kept");
+        });
+
+        suite.run("host_functions/unknown", []() {
+                const HostFunctions hostFunctions;
+                checkThrows<UnknownHostFunctionException>(
+                    [&]() { (void)callHostFunction(hostFunctions, "answer", {}); },
+                    "a name, which is not defined");
+        });
+}
+
+int main(int argc, char *argv[]) {
+        try {
+                TestSuite suite("vm", argc, argv);
+                statisticsTests(suite);
+                embeddingTests(suite);
+                hostFunctionTests(suite);
+                return suite.report(std::cout);
+
+        } catch (const std::exception &e) {
+                std::cerr << e.what() << std::endl;
+                return 1;
+        }
+}